@@ -0,0 +1,71 @@
+/*********************************************************************************************************************************************/
+/*  DocWire SDK: Award-winning modern data processing in C++20. SourceForge Community Choice & Microsoft support. AI-driven processing.      */
+/*  Supports nearly 100 data formats, including email boxes and OCR. Boost efficiency in text extraction, web data extraction, data mining,  */
+/*  document analysis. Offline processing possible for security and confidentiality                                                          */
+/*                                                                                                                                           */
+/*  Copyright (c) SILVERCODERS Ltd, http://silvercoders.com                                                                                  */
+/*  Project homepage: https://github.com/docwire/docwire                                                                                     */
+/*                                                                                                                                           */
+/*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
+/*********************************************************************************************************************************************/
+
+#ifndef DOCWIRE_CELL_ADDRESS_H
+#define DOCWIRE_CELL_ADDRESS_H
+
+#include <optional>
+#include <string_view>
+
+namespace docwire
+{
+
+struct cell_address
+{
+  int column;
+  int row;
+};
+
+/**
+ * @brief Decodes A1-style cell reference like "AB12" to 1-based column and row numbers.
+ *
+ * "$" markers of absolute references are accepted and column letters are case insensitive.
+ * References with more column letters or row digits than a spreadsheet can have are rejected.
+ *
+ * @return Decoded address or std::nullopt if the reference is malformed.
+ */
+inline std::optional<cell_address> decode_cell_address(std::string_view addr)
+{
+  constexpr size_t max_column_letters = 3; // "XFD" (16384) is the last Excel column
+  constexpr size_t max_row_digits = 9;
+  size_t pos = 0;
+  if (pos < addr.size() && addr[pos] == '$')
+    ++pos;
+  int column = 0;
+  size_t column_start = pos;
+  while (pos < addr.size() && ((addr[pos] >= 'A' && addr[pos] <= 'Z') || (addr[pos] >= 'a' && addr[pos] <= 'z')))
+  {
+    if (pos - column_start == max_column_letters)
+      return std::nullopt;
+    column = column * 26 + ((addr[pos] | 0x20) - 'a') + 1;
+    ++pos;
+  }
+  if (pos == column_start)
+    return std::nullopt;
+  if (pos < addr.size() && addr[pos] == '$')
+    ++pos;
+  int row = 0;
+  size_t row_start = pos;
+  while (pos < addr.size() && addr[pos] >= '0' && addr[pos] <= '9')
+  {
+    if (pos - row_start == max_row_digits)
+      return std::nullopt;
+    row = row * 10 + (addr[pos] - '0');
+    ++pos;
+  }
+  if (pos == row_start || pos != addr.size())
+    return std::nullopt;
+  return cell_address{column, row};
+}
+
+} // namespace docwire
+
+#endif // DOCWIRE_CELL_ADDRESS_H
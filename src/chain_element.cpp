@@ -11,6 +11,7 @@
 
 #include "chain_element.h"
 #include "parsing_chain.h"
+#include "profiling.h"
 
 namespace docwire
 {
@@ -28,7 +29,7 @@ struct pimpl_impl<ChainElement> : pimpl_impl_base
     info.cancel = continuation == ChainElement::continuation::stop;
   }
 
-  mutable std::function<ChainElement::continuation(const Tag&)> m_callback;
+  mutable std::function<ChainElement::continuation(Tag&)> m_callback;
   std::optional<std::reference_wrapper<ParsingChain>> m_chain;
 };
 
@@ -38,8 +39,15 @@ ChainElement::ChainElement()
 
 ChainElement::continuation ChainElement::operator()(const Tag& tag, std::function<continuation(const Tag&)> callback)
 {
-  impl().m_callback = callback;
-  Info info{tag};
+  Tag tag_copy{tag};
+  return process_in_place(tag_copy, [callback](Tag& tag) { return callback(tag); });
+}
+
+ChainElement::continuation ChainElement::process_in_place(Tag& tag, std::function<continuation(Tag&)> callback)
+{
+  profiling::scope profiling_scope{typeid(*this), tag};
+  impl().m_callback = std::move(callback);
+  Info info{std::ref(tag)};
   process(info);
   if (info.cancel)
     return continuation::stop;
@@ -15,21 +15,78 @@
 #include "defines.h"
 #include "pimpl.h"
 #include "tags.h"
+#include <functional>
+#include <optional>
 
 namespace docwire
 {
 
 class ParsingChain;
 
+/**
+ * @brief Tag passed through the parsing chain together with flags set by chain elements.
+ *
+ * Info either owns the tag or borrows tag owned by the caller. Chain elements pass borrowed tags to following
+ * elements, so a tag is not copied on every step of the chain. Elements can read the tag or modify it in place
+ * before emitting it further.
+ */
 struct DllExport Info
 {
-  Tag tag;
+private:
+  std::optional<Tag> m_owned_tag;
+
+public:
+  Tag& tag;
   bool cancel = false; //!< cancel flag. If set true then parsing process will be stopped.
   bool skip = false; //!< skip flag. If set true then tag will be skipped.
 
   explicit Info(const Tag& tag)
-    : tag(tag)
+    : m_owned_tag{tag}, tag{*m_owned_tag}
+  {}
+
+  explicit Info(Tag&& tag)
+    : m_owned_tag{std::move(tag)}, tag{*m_owned_tag}
   {}
+
+  /**
+   * @brief Borrow the tag without copying it. The tag has to outlive Info object.
+   */
+  explicit Info(std::reference_wrapper<Tag> tag)
+    : tag{tag.get()}
+  {}
+
+  Info(const Info& other)
+    : m_owned_tag{other.m_owned_tag}, tag{m_owned_tag ? *m_owned_tag : other.tag}, cancel{other.cancel}, skip{other.skip}
+  {}
+
+  Info(Info&& other)
+    : m_owned_tag{std::move(other.m_owned_tag)}, tag{m_owned_tag ? *m_owned_tag : other.tag}, cancel{other.cancel}, skip{other.skip}
+  {}
+
+  /**
+   * @brief Assigns tag and flags of other Info. Borrowed tag is modified in place.
+   */
+  Info& operator=(const Info& other)
+  {
+    tag = other.tag;
+    cancel = other.cancel;
+    skip = other.skip;
+    return *this;
+  }
+
+  /**
+   * @brief Assigns tag and flags of other Info. Tag is moved only if other Info owns it.
+   */
+  Info& operator=(Info&& other)
+  {
+    if (other.m_owned_tag)
+      tag = std::move(*other.m_owned_tag);
+    else
+      tag = other.tag;
+    cancel = other.cancel;
+    skip = other.skip;
+    return *this;
+  }
 };
 
 class DllExport ChainElement : public with_pimpl<ChainElement>
@@ -43,6 +100,14 @@ public:
   enum class continuation { proceed, skip, stop };
   continuation operator()(const Tag& tag, std::function<continuation(const Tag&)> callback);
 
+  /**
+   * @brief Process the tag owned by the caller without copying it.
+   *
+   * The element and following elements of the chain can modify the tag in place.
+   * Callback receives the same tag (or a tag created by the element) by reference.
+   */
+  continuation process_in_place(Tag& tag, std::function<continuation(Tag&)> callback);
+
   /**
    * @brief Check if ChainElement is a leaf (last element which doesn't produce any tags). At this moment only Exporters are leafs.
    * @return true if leaf
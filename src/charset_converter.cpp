@@ -0,0 +1,173 @@
+/*********************************************************************************************************************************************/
+/*  DocWire SDK: Award-winning modern data processing in C++20. SourceForge Community Choice & Microsoft support. AI-driven processing.      */
+/*  Supports nearly 100 data formats, including email boxes and OCR. Boost efficiency in text extraction, web data extraction, data mining,  */
+/*  document analysis. Offline processing possible for security and confidentiality                                                          */
+/*                                                                                                                                           */
+/*  Copyright (c) SILVERCODERS Ltd, http://silvercoders.com                                                                                  */
+/*  Project homepage: https://github.com/docwire/docwire                                                                                     */
+/*                                                                                                                                           */
+/*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
+/*********************************************************************************************************************************************/
+
+
+#include "charset_converter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <iconv.h>
+#include "make_error.h"
+#include <memory>
+#include "throw_if.h"
+#include <unordered_map>
+
+namespace docwire
+{
+
+/**
+	Owns iconv conversion descriptor converting from given charset to UTF-8.
+*/
+class iconv_converter
+{
+public:
+	explicit iconv_converter(const std::string& charset)
+		: m_descriptor{iconv_open("UTF-8", charset.c_str())}
+	{
+		throw_if (m_descriptor == reinterpret_cast<iconv_t>(-1), "iconv_open() failed", charset, errno);
+	}
+
+	~iconv_converter()
+	{
+		iconv_close(m_descriptor);
+	}
+
+	iconv_converter(const iconv_converter&) = delete;
+	iconv_converter& operator=(const iconv_converter&) = delete;
+
+	/**
+		Resets shift state left by previous text. Byte order detected from BOM is not reset by all iconv implementations.
+	*/
+	void reset()
+	{
+		iconv(m_descriptor, nullptr, nullptr, nullptr, nullptr);
+	}
+
+	/**
+		Invalid byte sequences are skipped, incomplete sequence at the end of text is dropped.
+	*/
+	std::string convert(std::string_view text)
+	{
+		std::string output(text.size() * 2 + 4, '\0');
+		char* in = const_cast<char*>(text.data());
+		size_t in_left = text.size();
+		size_t out_pos = 0;
+		while (in_left > 0)
+		{
+			char* out = output.data() + out_pos;
+			size_t out_left = output.size() - out_pos;
+			size_t result = iconv(m_descriptor, &in, &in_left, &out, &out_left);
+			out_pos = out - output.data();
+			if (result != static_cast<size_t>(-1))
+				break;
+			if (errno == E2BIG)
+				output.resize(output.size() * 2);
+			else if (errno == EILSEQ)
+			{
+				++in;
+				--in_left;
+			}
+			else
+				break;
+		}
+		output.resize(out_pos);
+		return output;
+	}
+
+private:
+	iconv_t m_descriptor;
+};
+
+namespace
+{
+
+std::string normalized_charset_name(const std::string& charset)
+{
+	std::string name;
+	for (char c : charset)
+		if (c != '-' && c != '_')
+			name += std::toupper(static_cast<unsigned char>(c));
+	return name;
+}
+
+bool is_ascii_compatible(const std::string& normalized_name)
+{
+	for (std::string_view prefix : { "UTF16", "UTF32", "UCS2", "UCS4", "UTF7", "UNICODE", "ISO2022", "HZ" })
+		if (normalized_name.starts_with(prefix))
+			return false;
+	return normalized_name.find("EBCDIC") == std::string::npos;
+}
+
+/**
+	Decoding depends on previous text: byte order detected from BOM or shift state.
+*/
+bool is_stateful(const std::string& normalized_name)
+{
+	for (std::string_view name : { "UTF16", "UTF32", "UCS2", "UCS4", "UNICODE" })
+		if (normalized_name == name)
+			return true;
+	for (std::string_view prefix : { "UTF7", "ISO2022", "HZ" })
+		if (normalized_name.starts_with(prefix))
+			return true;
+	return false;
+}
+
+bool is_ascii(std::string_view text)
+{
+	// ESC starts escape sequences in stateful encodings
+	return std::all_of(text.begin(), text.end(), [](char c) { return static_cast<unsigned char>(c) < 0x80 && c != 0x1B; });
+}
+
+iconv_converter& cached_converter(const std::string& charset)
+{
+	thread_local std::unordered_map<std::string, std::unique_ptr<iconv_converter>> converters;
+	auto converter_it = converters.find(charset);
+	if (converter_it == converters.end())
+		converter_it = converters.emplace(charset, std::make_unique<iconv_converter>(charset)).first;
+	return *converter_it->second;
+}
+
+} // anonymous namespace
+
+charset_converter::charset_converter(const std::string& charset)
+	: m_converter(nullptr)
+{
+	std::string normalized_name = normalized_charset_name(charset);
+	m_ascii_compatible = is_ascii_compatible(normalized_name);
+	if (normalized_name == "UTF8" || normalized_name == "ASCII" || normalized_name == "USASCII")
+		return;
+	try
+	{
+		if (is_stateful(normalized_name))
+		{
+			m_owned_converter = std::make_shared<iconv_converter>(charset);
+			m_converter = m_owned_converter.get();
+		}
+		else
+			m_converter = &cached_converter(charset);
+	}
+	catch (const std::exception& e)
+	{
+		std::throw_with_nested(make_error("Cannot create charset to UTF-8 converter", charset));
+	}
+}
+
+std::string charset_converter::to_utf8(std::string_view text) const
+{
+	if (!m_converter || (m_ascii_compatible && is_ascii(text)))
+		return std::string{text};
+	if (!m_owned_converter)
+		m_converter->reset();
+	return m_converter->convert(text);
+}
+
+} // namespace docwire
@@ -0,0 +1,56 @@
+/*********************************************************************************************************************************************/
+/*  DocWire SDK: Award-winning modern data processing in C++20. SourceForge Community Choice & Microsoft support. AI-driven processing.      */
+/*  Supports nearly 100 data formats, including email boxes and OCR. Boost efficiency in text extraction, web data extraction, data mining,  */
+/*  document analysis. Offline processing possible for security and confidentiality                                                          */
+/*                                                                                                                                           */
+/*  Copyright (c) SILVERCODERS Ltd, http://silvercoders.com                                                                                  */
+/*  Project homepage: https://github.com/docwire/docwire                                                                                     */
+/*                                                                                                                                           */
+/*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
+/*********************************************************************************************************************************************/
+
+
+#ifndef DOCWIRE_CHARSET_CONVERTER_H
+#define DOCWIRE_CHARSET_CONVERTER_H
+
+#include "defines.h"
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace docwire
+{
+
+class iconv_converter;
+
+/**
+ * @brief Converts text from given charset to UTF-8.
+ *
+ * iconv based converters are created once per thread and charset and reused by all parsers, so no locking is needed
+ * and iconv is not initialized again for every document or text fragment. Charsets whose decoding depends on previous
+ * text (byte order detected from BOM, shift state) are not cached: every object has its own converter, so the state
+ * is kept between texts converted by the object and is not passed to other documents. Text that is UTF-8 already
+ * or contains only ASCII characters in ASCII compatible charset is returned without calling iconv at all.
+ *
+ * Object uses converter cached for the thread that created it and must not be passed to other threads.
+ */
+class DllExport charset_converter
+{
+public:
+	/**
+	 * @param charset Name of source charset as accepted by iconv.
+	 * @throws error if conversion from charset to UTF-8 is not supported.
+	 */
+	explicit charset_converter(const std::string& charset);
+
+	std::string to_utf8(std::string_view text) const;
+
+private:
+	iconv_converter* m_converter; //!< nullptr if charset is UTF-8 or ASCII
+	std::shared_ptr<iconv_converter> m_owned_converter; //!< set if charset is stateful
+	bool m_ascii_compatible;
+};
+
+} // namespace docwire
+
+#endif //DOCWIRE_CHARSET_CONVERTER_H
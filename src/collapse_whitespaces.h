@@ -0,0 +1,33 @@
+/*********************************************************************************************************************************************/
+/*  DocWire SDK: Award-winning modern data processing in C++20. SourceForge Community Choice & Microsoft support. AI-driven processing.      */
+/*  Supports nearly 100 data formats, including email boxes and OCR. Boost efficiency in text extraction, web data extraction, data mining,  */
+/*  document analysis. Offline processing possible for security and confidentiality                                                          */
+/*                                                                                                                                           */
+/*  Copyright (c) SILVERCODERS Ltd, http://silvercoders.com                                                                                  */
+/*  Project homepage: https://github.com/docwire/docwire                                                                                     */
+/*                                                                                                                                           */
+/*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
+/*********************************************************************************************************************************************/
+
+#ifndef DOCWIRE_COLLAPSE_WHITESPACES_H
+#define DOCWIRE_COLLAPSE_WHITESPACES_H
+
+#include "defines.h"
+#include <string>
+
+namespace docwire
+{
+
+/**
+ * @brief Converts all HTML whitespaces into spaces and reduces all adjacent spaces into a single space, in place.
+ *
+ * HTML whitespaces are space, tab, line feed, vertical tab, form feed and carriage return.
+ * Leading and trailing whitespaces are reduced to a single space but not removed.
+ *
+ * @see https://developer.mozilla.org/en-US/docs/Web/API/Document_Object_Model/Whitespace#what_is_whitespace
+ */
+DllExport void collapse_whitespaces(std::string& text);
+
+} // namespace docwire
+
+#endif // DOCWIRE_COLLAPSE_WHITESPACES_H
@@ -17,6 +17,7 @@
 #include "log.h"
 #include "make_error.h"
 #include "misc.h"
+#include "throw_if.h"
 #include "xml_stream.h"
 #include "xml_fixer.h"
 
@@ -69,17 +70,23 @@ struct pimpl_impl<CommonXMLDocumentParser> : with_pimpl_owner<CommonXMLDocumentP
 	std::map<std::string, CommonXMLDocumentParser::ListStyleVector> m_list_styles;
 	std::map<int, CommonXMLDocumentParser::Comment> m_comments;
 	std::map<std::string, CommonXMLDocumentParser::Relationship> m_relationships;
-	std::vector<CommonXMLDocumentParser::SharedString> m_shared_strings;
+	std::shared_ptr<std::vector<CommonXMLDocumentParser::SharedString>> m_shared_strings =
+		std::make_shared<std::vector<CommonXMLDocumentParser::SharedString>>();
+	std::vector<Tag>* m_tag_buffer = nullptr;
 	std::map<std::string, CommonXMLDocumentParser::CommandHandler> m_command_handlers;
 
 	bool m_disabled_text;
 	int m_xml_options;
 
-	void send_tag(const Tag& tag) const
+	template <typename T>
+	void send_tag(T&& tag) const
 	{
 		if (!stop_emmit_signals)
 		{
-			owner().sendTag(tag);
+			if (m_tag_buffer)
+				m_tag_buffer->emplace_back(std::forward<T>(tag));
+			else
+				owner().sendTag(std::forward<T>(tag));
 		}
 	}
 
@@ -297,9 +304,23 @@ CommonXMLDocumentParser::trySendTag(const Tag& tag) const
   impl().send_tag(tag);
 }
 
+void
+CommonXMLDocumentParser::trySendTag(Tag&& tag) const
+{
+  impl().send_tag(std::move(tag));
+}
+
 void CommonXMLDocumentParser::send_error(std::exception_ptr e) const
 {
-	sendTag(e);
+	if (impl().m_tag_buffer)
+		impl().m_tag_buffer->emplace_back(e);
+	else
+		sendTag(e);
+}
+
+void CommonXMLDocumentParser::bufferTags(std::vector<Tag>* buffer)
+{
+	impl().m_tag_buffer = buffer;
 }
 
 void
@@ -656,6 +677,26 @@ void CommonXMLDocumentParser::extractText(const std::string& xml_contents, XmlPa
 	}
 }
 
+void CommonXMLDocumentParser::extractText(ZipReader& zipfile, const std::string& file_name, XmlParseMode mode, std::string& text)
+{
+	if (mode != PARSE_XML)
+	{
+		std::string xml_contents;
+		throw_if(!zipfile.read(file_name, &xml_contents), "Error reading XML file from ZIP file", file_name);
+		extractText(xml_contents, mode, &zipfile, text);
+		return;
+	}
+	try
+	{
+		XmlStream xml_stream(zipfile, file_name, getXmlOptions());
+		text = parseXmlData(xml_stream, mode, &zipfile);
+	}
+	catch (const std::exception& e)
+	{
+		std::throw_with_nested(make_error("Parsing XML failed"));
+	}
+}
+
 void CommonXMLDocumentParser::parseODFMetadata(const std::string &xml_content, attributes::Metadata& metadata) const
 {
 	try
@@ -742,7 +783,12 @@ std::map<std::string, CommonXMLDocumentParser::Relationship>& CommonXMLDocumentP
 
 std::vector<CommonXMLDocumentParser::SharedString>& CommonXMLDocumentParser::getSharedStrings()
 {
-	return impl().m_shared_strings;
+	return *impl().m_shared_strings;
+}
+
+void CommonXMLDocumentParser::shareSharedStrings(const CommonXMLDocumentParser& other)
+{
+	impl().m_shared_strings = other.impl().m_shared_strings;
 }
 
 bool CommonXMLDocumentParser::disabledText() const
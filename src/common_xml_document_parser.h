@@ -88,6 +88,9 @@ class CommonXMLDocumentParser: public Parser, public with_pimpl<CommonXMLDocumen
 		///extracts text from xml data. It uses parseXmlData internally.
 		void extractText(const std::string& xml_contents, XmlParseMode mode, ZipReader* zipfile, std::string& text);
 
+		///extracts text from xml file stored in zip archive. In PARSE_XML mode file is streamed instead of being loaded into memory.
+		void extractText(ZipReader& zipfile, const std::string& file_name, XmlParseMode mode, std::string& text);
+
 		///usefull since two parsers use this.
 		void parseODFMetadata(const std::string &xml_content, attributes::Metadata& metadata) const;
 
@@ -109,6 +112,9 @@ class CommonXMLDocumentParser: public Parser, public with_pimpl<CommonXMLDocumen
 		///gets vector of shared strings for reading and writing
 		std::vector<SharedString>& getSharedStrings();
 
+		///uses the same vector of shared strings as other parser. It is only read while worksheets are parsed, so parsers in different threads can share it.
+		void shareSharedStrings(const CommonXMLDocumentParser& other);
+
 		///checks if writing to the text is disabled (only inside onUnregisteredCommand!)
 		bool disabledText() const;
 
@@ -124,8 +130,12 @@ class CommonXMLDocumentParser: public Parser, public with_pimpl<CommonXMLDocumen
 		void activeEmittingSignals(bool flag);
 
 		void trySendTag(const Tag& tag) const;
+		void trySendTag(Tag&& tag) const;
 		void send_error(const std::exception_ptr e) const;
 
+		///collects tags sent by command handlers in the buffer instead of sending them, e.g. when parsing in worker thread. nullptr restores sending.
+		void bufferTags(std::vector<Tag>* buffer);
+
 	//public interface
 	public:
 		CommonXMLDocumentParser();
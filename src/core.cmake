@@ -32,7 +32,9 @@ add_library(docwire_core SHARED
     transformer_func.cpp
     meta_data_writer.cpp
     chain_element.cpp
+    charset_converter.cpp
     parsing_chain.cpp
+    profiling.cpp
     resource_path.cpp
     zip_reader.cpp
     input.cpp)
@@ -52,9 +54,10 @@ find_library(unzip unzip REQUIRED)
 find_package(ZLIB REQUIRED)
 find_package(LibArchive REQUIRED)
 find_package(unofficial-curlpp CONFIG REQUIRED)
+find_package(Iconv REQUIRED) # for charset conversion
 target_link_libraries(docwire_core PRIVATE
     ${wv2} Boost::filesystem Boost::system Boost::json magic_enum::magic_enum ${unzip}
-    ZLIB::ZLIB LibArchive::LibArchive unofficial::curlpp::curlpp docwire_base64)
+    ZLIB::ZLIB LibArchive::LibArchive unofficial::curlpp::curlpp Iconv::Iconv docwire_base64)
 target_link_libraries(docwire_core PUBLIC magic_enum::magic_enum)
 if(${CMAKE_SYSTEM_NAME} MATCHES "Linux")
     target_link_libraries(docwire_core PRIVATE dl)
@@ -11,6 +11,8 @@
 
 #include "data_source.h"
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 #include "error_tags.h"
 #include <fstream>
 #include "memorystream.h"
@@ -19,10 +21,54 @@
 namespace docwire
 {
 
+struct data_source::file_mapping
+{
+	boost::interprocess::file_mapping file;
+	boost::interprocess::mapped_region region;
+};
+
+std::optional<std::span<const std::byte>> data_source::mapped_file_span() const
+{
+	std::lock_guard<std::mutex> lock{m_file_mapping_mutex.v};
+	if (!m_file_mapping)
+	{
+		if (m_memory_cache)
+			return std::nullopt;
+		const std::filesystem::path& path = std::get<std::filesystem::path>(m_source);
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(path, ec))
+			return std::nullopt;
+		try
+		{
+			auto mapping = std::make_shared<file_mapping>();
+			if (std::filesystem::file_size(path) > 0) // empty file cannot be mapped
+			{
+				mapping->file = boost::interprocess::file_mapping{path.c_str(), boost::interprocess::read_only};
+				mapping->region = boost::interprocess::mapped_region{mapping->file, boost::interprocess::read_only};
+			}
+			m_file_mapping = mapping;
+		}
+		catch (const std::exception&)
+		{
+			return std::nullopt;
+		}
+	}
+	return std::span<const std::byte>{reinterpret_cast<const std::byte*>(m_file_mapping->region.get_address()), m_file_mapping->region.get_size()};
+}
+
 std::span<const std::byte> data_source::span(std::optional<length_limit> limit) const
 {
 	return std::visit(
 		overloaded {
+			[this, limit](const std::filesystem::path& source) -> std::span<const std::byte>
+			{
+				std::optional<std::span<const std::byte>> mapped = mapped_file_span();
+				if (mapped)
+					return limit ? mapped->first(std::min(mapped->size(), limit->v)) : *mapped;
+				fill_memory_cache(limit);
+				size_t size = limit ? std::min(m_memory_cache->size(), limit->v) : m_memory_cache->size();
+				return std::span<const std::byte>(m_memory_cache->data(), size);
+			},
 			[this, limit](const std::vector<std::byte>& source)
 			{
 				size_t size = limit ? std::min(source.size(), limit->v) : source.size();
@@ -56,6 +102,11 @@ std::string data_source::string(std::optional<length_limit> limit) const
 {
 	return std::visit(
 		overloaded {
+			[this, limit](const std::filesystem::path& source)
+			{
+				std::span<const std::byte> data = span(limit);
+				return std::string{reinterpret_cast<const char*>(data.data()), data.size()};
+			},
 			[this, limit](const std::vector<std::byte>& source)
 			{
 				if (limit)
@@ -121,15 +172,24 @@ std::optional<docwire::file_extension> data_source::file_extension() const
 namespace
 {
 
-void read_unseekable_stream_into_memory(std::shared_ptr<memory_buffer> buffer, std::shared_ptr<std::istream> stream, std::optional<length_limit> limit)
+void read_unseekable_stream_into_memory(std::shared_ptr<memory_buffer> buffer, std::optional<size_t>& stream_size, std::shared_ptr<std::istream> stream, std::optional<size_t> size_hint, std::optional<length_limit> limit)
 {
-	constexpr size_t chunk_size = 4096;
+	// Stream has been read to the end already. Buffer must not be resized again because spans of it are in use.
+	if (stream_size)
+		return;
+	constexpr size_t chunk_size = 65536;
+	// Size hint usually comes from untrusted headers (e.g. archive entries), so memory reserved up front is limited.
+	// Bigger streams are still read fully, buffer just grows geometrically past this point.
+	constexpr size_t max_size_hint_reservation = 64 * 1024 * 1024;
 	size_t size = buffer->size();
+	if (size_hint)
+		buffer->reserve(std::min(limit ? std::min(*size_hint, limit->v) : *size_hint, max_size_hint_reservation) + 1); // one more byte to detect end of stream without reallocation
 	for (;;)
 	{
 		if (limit && size >= limit->v)
 			break;
-		size_t to_read = limit ? std::min(chunk_size, limit->v - size) : chunk_size;
+		size_t available = std::max(chunk_size, buffer->capacity() - size);
+		size_t to_read = limit ? std::min(available, limit->v - size) : available;
 		buffer->resize(size + to_read);
 		throw_if (!stream->read(reinterpret_cast<char*>(buffer->data() + size), to_read) && !stream->eof());
 		size_t bytes_read = stream->gcount();
@@ -137,6 +197,7 @@ void read_unseekable_stream_into_memory(std::shared_ptr<memory_buffer> buffer, s
 		if (bytes_read < to_read)
 		{
 			buffer->resize(size);
+			stream_size = size;
 			break;
 		}
 	}
@@ -192,7 +253,7 @@ void data_source::fill_memory_cache(std::optional<length_limit> limit) const
 			{
 				if (!m_memory_cache)
 					m_memory_cache = std::make_shared<memory_buffer>(0);
-				read_unseekable_stream_into_memory(m_memory_cache, source.v, limit);
+				read_unseekable_stream_into_memory(m_memory_cache, m_stream_size, source.v, source.size_hint, limit);
 			}
 		},
 		m_source
@@ -15,9 +15,12 @@
 #include "defines.h"
 #include "file_extension.h"
 #include <filesystem>
+#include <functional>
 #include "memory_buffer.h"
+#include <mutex>
 #include <optional>
 #include <string_view>
+#include <typeindex>
 #include "unique_identifier.h"
 #include <unordered_map>
 #include <variant>
@@ -26,6 +29,7 @@
 namespace docwire
 {
 
+
 struct seekable_stream_ptr
 {
   std::shared_ptr<std::istream> v;
@@ -34,6 +38,7 @@ struct seekable_stream_ptr
 struct unseekable_stream_ptr
 {
   std::shared_ptr<std::istream> v;
+  std::optional<size_t> size_hint; //!< expected size of stream content if known, used to allocate memory once
 };
 
 struct length_limit
@@ -139,6 +144,11 @@ class DllExport data_source
 			add_mime_type(mime_type, mime_type_confidence);
 		}
 
+		/**
+			Returns content of data source as contiguous memory.
+			Once the whole source has been read, memory is not reallocated anymore: spans returned earlier stay valid
+			and further calls only read cached state, so they can be made concurrently (e.g. by parser workers).
+		**/
 		std::span<const std::byte> span(std::optional<length_limit> limit = std::nullopt) const;
 
 		std::string string(std::optional<length_limit> limit = std::nullopt) const;
@@ -201,6 +211,23 @@ class DllExport data_source
 				existing_it->second = c;
 		}
 
+		/**
+			Returns value of type T derived from content of the data source, e.g. zip central directory index.
+			Value is created by the function on first call and shared by all elements processing the source,
+			so it is computed once for content type detectors and parsers. If the function returns nullptr,
+			it is called again next time. Can be called concurrently, but the function must not call cached()
+			of the same data source.
+		**/
+		template <typename T>
+		std::shared_ptr<const T> cached(const std::function<std::shared_ptr<const T>()>& create) const
+		{
+			std::lock_guard<std::mutex> lock{m_cache_mutex.v};
+			std::shared_ptr<const void>& value = m_cache[std::type_index{typeid(T)}];
+			if (!value)
+				value = create();
+			return std::static_pointer_cast<const T>(value);
+		}
+
 		std::unordered_map<mime_type, confidence> mime_types;
 
 	private:
@@ -208,10 +235,33 @@ class DllExport data_source
 		std::optional<docwire::file_extension> m_file_extension;
 		mutable std::shared_ptr<memory_buffer> m_memory_cache;
 		mutable std::shared_ptr<std::istream> m_path_stream;
-		mutable std::optional<size_t> m_stream_size;
+		mutable std::optional<size_t> m_stream_size; //!< size of stream source, for unseekable stream known only after reaching its end
+		struct file_mapping;
+		mutable std::shared_ptr<file_mapping> m_file_mapping;
+
+		/**
+			Mutex guarding lazily initialized state, so const methods can be called concurrently.
+			Copies of data source get their own mutex.
+		**/
+		struct state_mutex
+		{
+			std::mutex v;
+			state_mutex() = default;
+			state_mutex(const state_mutex&) {}
+			state_mutex& operator=(const state_mutex&) { return *this; }
+		};
+		mutable state_mutex m_file_mapping_mutex;
+		mutable std::unordered_map<std::type_index, std::shared_ptr<const void>> m_cache; //!< values returned by cached()
+		mutable state_mutex m_cache_mutex;
 		unique_identifier m_id;
 
 		void fill_memory_cache(std::optional<length_limit> limit) const;
+
+		/**
+			Returns content of regular file source mapped read-only into memory, so span() does not copy it.
+			Returns std::nullopt if file cannot be mapped and has to be read into memory cache instead.
+		**/
+		std::optional<std::span<const std::byte>> mapped_file_span() const;
 };
 
 } // namespace docwire
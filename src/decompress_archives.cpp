@@ -77,6 +77,13 @@ public:
 
 		bool is_dir() { return (archive_entry_mode(m_entry) & AE_IFDIR); }
 
+		std::optional<size_t> get_size()
+		{
+			if (!archive_entry_size_is_set(m_entry) || archive_entry_size(m_entry) < 0)
+				return std::nullopt;
+			return archive_entry_size(m_entry);
+		}
+
 		std::unique_ptr<EntryIStream> create_stream() { return std::make_unique<EntryIStream>(m_archive); }
 
 		operator bool() { return m_entry != nullptr; }
@@ -222,7 +229,7 @@ DecompressArchives::process(Info& info)
 				docwire_log(debug) << "Skipping directory entry";
 				continue;
 			}
-			Info info(data_source{unseekable_stream_ptr{entry.create_stream()}, file_extension{std::filesystem::path{entry_name}}});
+			Info info(data_source{unseekable_stream_ptr{entry.create_stream(), entry.get_size()}, file_extension{std::filesystem::path{entry_name}}});
 			process(info);
 			docwire_log(debug) << "End of processing compressed file " << entry_name;
 		}
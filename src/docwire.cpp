@@ -9,9 +9,19 @@
 /*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
 /*********************************************************************************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <boost/json.hpp>
 #include <boost/program_options.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <fstream>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
 #include "analyze_data.h"
 #include "classify.h"
 #include "content_type.h"
@@ -34,10 +44,13 @@
 #include "output.h"
 #include "plain_text_exporter.h"
 #include "post.h"
+#include "profiling.h"
 #include "standard_filter.h"
 #include "summarize.h"
 #include "text_to_speech.h"
 #include "transcribe.h"
+#include "throw_if.h"
+#include "transformer_func.h"
 #include "translate_to.h"
 #include "version.h"
 #include "parsing_chain.h"
@@ -100,157 +113,103 @@ std::string enum_names_str()
 	return names_str;
 }
 
-int main(int argc, char* argv[])
-{
-	bool local_processing;
-	bool use_stream;
-
-	namespace po = boost::program_options;
-	po::options_description desc("Allowed options");
-	desc.add_options()
-		("help", "display help message")
-		("version", "display DocWire version")
-		("verbose", "enable verbose logging")
-		("input-file", po::value<std::string>()->required(), "path to file to process")
-		("output_type", po::value<OutputType>()->default_value(OutputType::plain_text), enum_names_str<OutputType>().c_str())
-		("http-post", po::value<std::string>(), "url to process data via http post")
-		("local-ai-prompt", po::value<std::string>(), "prompt to process text via local AI model")
-		("local-ai-model", po::value<std::string>(), "path to local AI model data (build-in default model is used if not specified)")
-		("openai-chat", po::value<std::string>(), "prompt to process text and images via OpenAI")
-		("openai-extract-entities", "extract entities from text and images via OpenAI")
-		("openai-extract-keywords", po::value<unsigned int>(), "extract N keywords/key phrases from text and images via OpenAI")
-		("openai-summarize", "summarize text and images via OpenAI")
-		("openai-detect-sentiment", "detect sentiment of text and images via OpenAI")
-		("openai-analyze-data", "analyze text and images for inportant insights and generate conclusions via OpenAI")
-		("openai-classify", po::value<std::vector<std::string>>()->multitoken(), "classify text and images via OpenAI to one of specified categories")
-		("openai-translate-to", po::value<std::string>(), "language to translate text and images to via OpenAI")
-		("openai-find", po::value<std::string>(), "find phrase, object or event in text and images via OpenAI")
-		("openai-text-to-speech", "convert text to speech via OpenAI")
-		("openai-transcribe", "convert speech to text (transcribe) via OpenAI")
-		("openai-key", po::value<std::string>()->default_value(""), "OpenAI API key")
-		("openai-model", po::value<openai::Model>()->default_value(openai::Model::gpt35_turbo), enum_names_str<openai::Model>().c_str())
-		("openai-tts-model", po::value<openai::TextToSpeech::Model>()->default_value(openai::TextToSpeech::Model::tts1), enum_names_str<openai::TextToSpeech::Model>().c_str())
-		("openai-voice", po::value<openai::TextToSpeech::Voice>()->default_value(openai::TextToSpeech::Voice::alloy), enum_names_str<openai::TextToSpeech::Voice>().c_str())
-		("openai-temperature", po::value<float>(), "force specified temperature for OpenAI prompts")
-		("openai-image-detail", po::value<openai::ImageDetail>()->default_value(openai::ImageDetail::automatic), enum_names_str<openai::ImageDetail>().c_str())
-		("language", po::value<std::vector<Language>>()->default_value({Language::eng}, "eng"), "Set the document language(s) for OCR as ISO 639-3 identifiers like: spa, fra, deu, rus, chi_sim, chi_tra etc. More than 100 languages are supported. Multiple languages can be enabled.")
-		("local-processing", po::value<bool>(&local_processing)->default_value(true), "process documents locally including OCR")
-		("use-stream", po::value<bool>(&use_stream)->default_value(false), "pass file stream to SDK instead of filename")
-		("min_creation_time", po::value<unsigned int>(), "filter emails by min creation time")
-		("max_creation_time", po::value<unsigned int>(), "filter emails by max creation time")
-		("max_nodes_number", po::value<unsigned int>(), "filter by max number of nodes")
-		("folder_name", po::value<std::string>(), "filter emails by folder name")
-		("attachment_extension", po::value<std::string>(), "filter by attachment type")
-		("log_file", po::value<std::string>(), "set path to log file")
-	;
-
-	po::positional_options_description pos_desc;
-	pos_desc.add("input-file", -1);
-
-	po::variables_map vm;
-	try
-	{
-		po::store(po::command_line_parser(argc, argv).options(desc).positional(pos_desc).run(), vm);
-	}
-	catch(const std::exception& e)
-	{
-		std::cerr << e.what() << '\n';
-		return 1;
-	}
-
-	if (vm.count("help"))
-	{
-		readme();
-		std::cout << std::endl << "Usage: docwire [options] file_name" << std::endl << std::endl << desc << std::endl;
-		return 0;
-	}
-
-	if (vm.count("version"))
-	{
-		version();
-		return 0;
-	}
-
-	try
-	{
-		po::notify(vm);
-	}
-	catch(const std::exception& e)
-	{
-		std::cerr << "Error: " << e.what() << std::endl;
-		return 1;
-	}
-
-	if (vm.count("verbose"))
-	{
-		set_log_verbosity(debug);
-	}
+namespace po = boost::program_options;
 
-	std::unique_ptr<std::ostream> log_stream;
-	if (vm.count("log_file"))
-	{
-		log_stream = std::make_unique<std::ofstream>(vm["log_file"].as<std::string>());
-		set_log_stream(log_stream.get());
-	}
+/**
+	Creates local AI model runner if it is needed by command line options.
+	Loading the model is expensive, so the runner is created once and shared by processing chains
+	of all batch workers. Translation requests of concurrent workers are queued by the translator.
+*/
+static std::shared_ptr<local_ai::model_runner> create_model_runner(const po::variables_map& vm)
+{
+	if (!vm.count("local-ai-prompt"))
+		return nullptr;
+	return vm.count("local-ai-model") ?
+		std::make_shared<local_ai::model_runner>(vm["local-ai-model"].as<std::string>()) :
+		std::make_shared<local_ai::model_runner>();
+}
 
-	std::string file_name = vm["input-file"].as<std::string>();
+/**
+	Creates content type detector and parsers. They do not keep state of processed document, but creating them
+	is expensive (e.g. detector loads the signatures database), so they are reused by chains created for next files.
+	They are not thread-safe, so every batch worker needs its own instance.
+*/
+static ref_or_owned<ChainElement> create_parsers(const po::variables_map& vm)
+{
+	return content_type::detector{} |
+		office_formats_parser{} | mail_parser{} | OCRParser{vm["language"].as<std::vector<Language>>()};
+}
 
-	docwire_log_vars(use_stream, file_name);
-	auto chain = use_stream ?
-		(std::ifstream{file_name, std::ios_base::binary} | DecompressArchives()) :
-		(std::filesystem::path{file_name} | DecompressArchives());
+/**
+	Creates chain of all processing steps selected in command line options, from archive decompression to the exporter.
+	The chain has no input and output. Some elements (e.g. filters) keep state of processed document,
+	so a new chain should be created for every input file. Parsers are created on first use and reused by next chains.
+*/
+static ParsingChain create_processing_chain(const po::variables_map& vm, std::shared_ptr<local_ai::model_runner> model_runner,
+	std::optional<ref_or_owned<ChainElement>>& parsers)
+{
+	std::vector<ref_or_owned<ChainElement>> elements;
+	elements.push_back(DecompressArchives());
 
 	if (vm.count("openai-transcribe"))
 	{
 		std::string api_key = vm["openai-key"].as<std::string>();
-		chain |= openai::Transcribe(api_key) | PlainTextExporter();
+		elements.push_back(openai::Transcribe(api_key) | PlainTextExporter());
 	}
-	else if (local_processing)
+	else if (vm["local-processing"].as<bool>())
 	{
-		chain |=
-			content_type::detector{} |
-			office_formats_parser{} | mail_parser{} | OCRParser{vm["language"].as<std::vector<Language>>()};
+		if (!parsers)
+			parsers.emplace(create_parsers(vm));
+		elements.push_back(*parsers);
 		if (vm.count("max_nodes_number"))
 		{
-			chain |= StandardFilter::filterByMaxNodeNumber(vm["max_nodes_number"].as<unsigned int>());
+			elements.push_back(TransformerFunc{StandardFilter::filterByMaxNodeNumber(vm["max_nodes_number"].as<unsigned int>())});
 		}
 		if (vm.count("min_creation_time"))
 		{
-			chain |= StandardFilter::filterByMailMinCreationTime(vm["min_creation_time"].as<unsigned int>());
+			elements.push_back(TransformerFunc{StandardFilter::filterByMailMinCreationTime(vm["min_creation_time"].as<unsigned int>())});
 		}
 		if (vm.count("max_creation_time"))
 		{
-			chain |= StandardFilter::filterByMailMaxCreationTime(vm["max_creation_time"].as<unsigned int>());
+			elements.push_back(TransformerFunc{StandardFilter::filterByMailMaxCreationTime(vm["max_creation_time"].as<unsigned int>())});
 		}
 		if (vm.count("folder_name"))
 		{
-			chain |= StandardFilter::filterByFolderName({vm["folder_name"].as<std::string>()});
+			elements.push_back(TransformerFunc{StandardFilter::filterByFolderName({vm["folder_name"].as<std::string>()})});
 		}
 		if (vm.count("attachment_extension"))
 		{
-			chain |= StandardFilter::filterByAttachmentType({file_extension{vm["attachment_extension"].as<std::string>()}});
+			elements.push_back(TransformerFunc{StandardFilter::filterByAttachmentType({file_extension{vm["attachment_extension"].as<std::string>()}})});
 		}
 
+		// Stream exported text to the output if it is not processed further
+		const char* const post_export_options[] = { "http-post", "openai-chat", "openai-extract-entities",
+			"openai-extract-keywords", "openai-summarize", "openai-detect-sentiment", "openai-analyze-data",
+			"openai-classify", "openai-translate-to", "local-ai-prompt", "openai-find", "openai-text-to-speech" };
+		bool exported_output_is_final = std::none_of(std::begin(post_export_options), std::end(post_export_options),
+			[&vm](const char* option) { return vm.count(option) > 0; });
+		flush_threshold exporter_flush_threshold { exported_output_is_final ? std::optional<size_t>{64 * 1024} : std::nullopt };
+
 		switch (vm["output_type"].as<OutputType>())
 		{
 			case OutputType::plain_text:
-				chain |= PlainTextExporter();
+				elements.push_back(PlainTextExporter(eol_sequence{"\n"}, PlainTextExporter::default_link_formatter, exporter_flush_threshold));
 				break;
 			case OutputType::html:
-				chain |= HtmlExporter();
+				elements.push_back(HtmlExporter(exporter_flush_threshold));
 				break;
 			case OutputType::csv:
-				chain |= CsvExporter();
+				elements.push_back(CsvExporter());
 				break;
 			case OutputType::metadata:
-				chain |= MetaDataExporter();
+				elements.push_back(MetaDataExporter());
 				break;
 		}
 	}
 
 	if (vm.count("http-post"))
 	{
-		chain |= http::Post(vm["http-post"].as<std::string>());
+		elements.push_back(http::Post(vm["http-post"].as<std::string>()));
 	}
 
 	if (vm.count("openai-chat"))
@@ -259,10 +218,9 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::Model model = vm["openai-model"].as<openai::Model>();
 		openai::ImageDetail image_detail = vm["openai-image-detail"].as<openai::ImageDetail>();
-		chain |=
-			openai::Chat(prompt, api_key, model,
+		elements.push_back(openai::Chat(prompt, api_key, model,
 				vm.count("openai-temperature") ? vm["openai-temperature"].as<float>() : 0,
-				image_detail);
+				image_detail));
 	}
 
 	if (vm.count("openai-extract-entities"))
@@ -270,10 +228,9 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::Model model = vm["openai-model"].as<openai::Model>();
 		openai::ImageDetail image_detail = vm["openai-image-detail"].as<openai::ImageDetail>();
-		chain |=
-			openai::ExtractEntities(api_key, model,
+		elements.push_back(openai::ExtractEntities(api_key, model,
 				vm.count("openai-temperature") ? vm["openai-temperature"].as<float>() : 0,
-				image_detail);
+				image_detail));
 	}
 
 	if (vm.count("openai-extract-keywords"))
@@ -282,10 +239,9 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::Model model = vm["openai-model"].as<openai::Model>();
 		openai::ImageDetail image_detail = vm["openai-image-detail"].as<openai::ImageDetail>();
-		chain |=
-			openai::ExtractKeywords(max_keywords, api_key, model,
+		elements.push_back(openai::ExtractKeywords(max_keywords, api_key, model,
 				vm.count("openai-temperature") ? vm["openai-temperature"].as<float>() : 0,
-				image_detail);
+				image_detail));
 	}
 
 	if (vm.count("openai-summarize"))
@@ -293,10 +249,9 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::Model model = vm["openai-model"].as<openai::Model>();
 		openai::ImageDetail image_detail = vm["openai-image-detail"].as<openai::ImageDetail>();
-		chain |=
-			openai::Summarize(api_key, model,
+		elements.push_back(openai::Summarize(api_key, model,
 				vm.count("openai-temperature") ? vm["openai-temperature"].as<float>() : 0,
-				image_detail);
+				image_detail));
 	}
 
 	if (vm.count("openai-detect-sentiment"))
@@ -304,10 +259,9 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::Model model = vm["openai-model"].as<openai::Model>();
 		openai::ImageDetail image_detail = vm["openai-image-detail"].as<openai::ImageDetail>();
-		chain |=
-			openai::DetectSentiment(api_key, model,
+		elements.push_back(openai::DetectSentiment(api_key, model,
 				vm.count("openai-temperature") ? vm["openai-temperature"].as<float>() : 0,
-				image_detail);
+				image_detail));
 	}
 
 	if (vm.count("openai-analyze-data"))
@@ -315,10 +269,9 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::Model model = vm["openai-model"].as<openai::Model>();
 		openai::ImageDetail image_detail = vm["openai-image-detail"].as<openai::ImageDetail>();
-		chain |=
-			openai::AnalyzeData(api_key, model,
+		elements.push_back(openai::AnalyzeData(api_key, model,
 				vm.count("openai-temperature") ? vm["openai-temperature"].as<float>() : 0,
-				image_detail);
+				image_detail));
 	}
 
 	if (vm.count("openai-classify"))
@@ -328,10 +281,9 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::Model model = vm["openai-model"].as<openai::Model>();
 		openai::ImageDetail image_detail = vm["openai-image-detail"].as<openai::ImageDetail>();
-		chain |=
-			openai::Classify(categories_set, api_key, model,
+		elements.push_back(openai::Classify(categories_set, api_key, model,
 				vm.count("openai-temperature") ? vm["openai-temperature"].as<float>() : 0,
-				image_detail);
+				image_detail));
 	}
 
 	if (vm.count("openai-translate-to"))
@@ -340,30 +292,15 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::Model model = vm["openai-model"].as<openai::Model>();
 		openai::ImageDetail image_detail = vm["openai-image-detail"].as<openai::ImageDetail>();
-		chain |=
-			openai::TranslateTo(language, api_key, model,
+		elements.push_back(openai::TranslateTo(language, api_key, model,
 				vm.count("openai-temperature") ? vm["openai-temperature"].as<float>() : 0,
-				image_detail);
+				image_detail));
 	}
 
 	if (vm.count("local-ai-prompt"))
 	{
-		try
-		{
-			std::string prompt = vm["local-ai-prompt"].as<std::string>();
-
-			auto model_runner = vm.count("local-ai-model") ?
-				std::make_shared<local_ai::model_runner>(vm["local-ai-model"].as<std::string>()) :
-				std::make_shared<local_ai::model_runner>();
-			
-			chain |=
-				local_ai::model_chain_element(prompt, model_runner);
-		}
-		catch(const std::exception& e)
-		{
-			std::cerr << "Error: " << errors::diagnostic_message(e) << std::endl;
-			return 1;
-		}
+		std::string prompt = vm["local-ai-prompt"].as<std::string>();
+		elements.push_back(local_ai::model_chain_element(prompt, model_runner));
 	}
 
 	if (vm.count("openai-find"))
@@ -372,10 +309,9 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::Model model = vm["openai-model"].as<openai::Model>();
 		openai::ImageDetail image_detail = vm["openai-image-detail"].as<openai::ImageDetail>();
-		chain |=
-			openai::Find(what, api_key, model,
+		elements.push_back(openai::Find(what, api_key, model,
 				vm.count("openai-temperature") ? vm["openai-temperature"].as<float>() : 0,
-				image_detail);
+				image_detail));
 	}
 
 	if (vm.count("openai-text-to-speech"))
@@ -383,20 +319,300 @@ int main(int argc, char* argv[])
 		std::string api_key = vm["openai-key"].as<std::string>();
 		openai::TextToSpeech::Model model = vm["openai-tts-model"].as<openai::TextToSpeech::Model>();
 		openai::TextToSpeech::Voice voice = vm["openai-voice"].as<openai::TextToSpeech::Voice>();
-		chain |= openai::TextToSpeech(api_key, model, voice);
+		elements.push_back(openai::TextToSpeech(api_key, model, voice));
 	}
 
-	chain |= [](Info& info)
+	elements.push_back(TransformerFunc{[](Info& info)
 	{
 		if (!std::holds_alternative<std::exception_ptr>(info.tag))
 			return;
 		std::clog << "[WARNING] " <<
 			errors::diagnostic_message(std::get<std::exception_ptr>(info.tag)) << std::endl;
+	}});
+
+	ParsingChain chain = elements[0] | elements[1];
+	for (size_t i = 2; i < elements.size(); i++)
+		chain |= elements[i];
+	return chain;
+}
+
+
+
+/**
+	Bounded queue of files waiting for batch processing workers.
+*/
+class batch_queue
+{
+public:
+	explicit batch_queue(size_t max_size)
+		: m_max_size{max_size}
+	{}
+
+	void push(const std::filesystem::path& file)
+	{
+		std::unique_lock<std::mutex> lock{m_mutex};
+		m_not_full.wait(lock, [this]() { return m_files.size() < m_max_size; });
+		m_files.push_back(file);
+		m_not_empty.notify_one();
+	}
+
+	std::optional<std::filesystem::path> pop()
+	{
+		std::unique_lock<std::mutex> lock{m_mutex};
+		m_not_empty.wait(lock, [this]() { return !m_files.empty() || m_closed; });
+		if (m_files.empty())
+			return std::nullopt;
+		std::filesystem::path file = m_files.front();
+		m_files.pop_front();
+		m_not_full.notify_one();
+		return file;
+	}
+
+	void close()
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		m_closed = true;
+		m_not_empty.notify_all();
+	}
+
+	size_t size()
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		return m_files.size();
+	}
+
+private:
+	size_t m_max_size;
+	std::deque<std::filesystem::path> m_files;
+	bool m_closed = false;
+	std::mutex m_mutex;
+	std::condition_variable m_not_empty;
+	std::condition_variable m_not_full;
+};
+
+struct batch_statistics
+{
+	std::atomic<size_t> processed_files{0};
+	std::atomic<size_t> failed_files{0};
+	std::atomic<uintmax_t> processed_bytes{0};
+};
+
+static void report_batch_progress(const batch_statistics& statistics, size_t queue_depth,
+	std::chrono::steady_clock::time_point start_time)
+{
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+	size_t processed_files = statistics.processed_files;
+	double megabytes = statistics.processed_bytes.load() / (1024.0 * 1024.0);
+	std::clog << "[INFO] processed files: " << processed_files <<
+		", failed files: " << statistics.failed_files.load() <<
+		", queue depth: " << queue_depth <<
+		", files/s: " << (seconds > 0 ? processed_files / seconds : 0) <<
+		", MB/s: " << (seconds > 0 ? megabytes / seconds : 0) << std::endl;
+}
+
+static std::string output_file_extension(OutputType output_type)
+{
+	switch (output_type)
+	{
+		case OutputType::html:
+			return ".html";
+		case OutputType::csv:
+			return ".csv";
+		default:
+			return ".txt";
+	}
+}
+
+/**
+	Processes files listed in --input-list or found in --input-dir using a pool of worker threads.
+	Every worker creates a fresh processing chain for each file it takes from the queue, reusing its own parsers.
+	All workers share the local AI model runner. Results are written to --output-dir or, if it is not set, to standard output as JSON lines.
+*/
+static int process_batch(const po::variables_map& vm, bool use_stream)
+{
+	unsigned int workers_count = vm.count("workers") ? std::max(1u, vm["workers"].as<unsigned int>()) : std::max(1u, std::thread::hardware_concurrency());
+	docwire_log_var(workers_count);
+	std::optional<std::filesystem::path> output_dir;
+	if (vm.count("output-dir"))
+		output_dir = vm["output-dir"].as<std::string>();
+	std::optional<std::filesystem::path> input_dir;
+	if (vm.count("input-dir"))
+		input_dir = vm["input-dir"].as<std::string>();
+	std::string extension = output_file_extension(vm["output_type"].as<OutputType>());
+
+	std::shared_ptr<local_ai::model_runner> model_runner;
+	std::vector<std::optional<ref_or_owned<ChainElement>>> workers_parsers(workers_count);
+	try
+	{
+		model_runner = create_model_runner(vm);
+		create_processing_chain(vm, model_runner, workers_parsers.front()); // report invalid options before processing starts
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << errors::diagnostic_message(e) << std::endl;
+		return 1;
+	}
+
+	batch_queue queue{workers_count * 4};
+	batch_statistics statistics;
+	std::mutex json_output_mutex;
+	std::set<std::filesystem::path> output_paths;
+	std::mutex output_paths_mutex;
+
+	auto process_file = [&](std::optional<ref_or_owned<ChainElement>>& parsers, const std::filesystem::path& file)
+	{
+		std::error_code ec;
+		uintmax_t file_size = std::filesystem::file_size(file, ec);
+		std::optional<std::string> error_message;
+		std::ostringstream json_output_stream;
+		try
+		{
+			std::unique_ptr<std::ostream> output_stream;
+			if (output_dir)
+			{
+				std::filesystem::path output_path = *output_dir /
+					(input_dir ? std::filesystem::relative(file, *input_dir) : file.relative_path());
+				output_path += extension;
+				output_path = output_path.lexically_normal();
+				std::filesystem::path relative_output_path = output_path.lexically_relative(output_dir->lexically_normal());
+				throw_if (relative_output_path.empty() || *relative_output_path.begin() == "..",
+					"Output path is outside of output directory", output_path);
+				{
+					std::lock_guard<std::mutex> lock{output_paths_mutex};
+					throw_if (!output_paths.insert(output_path).second,
+						"Output path collides with output of another input file", output_path);
+				}
+				std::filesystem::create_directories(output_path.parent_path());
+				output_stream = std::make_unique<std::ofstream>(output_path, std::ios_base::binary);
+				throw_if (!output_stream->good(), "Cannot open output file", output_path);
+			}
+			std::ostream& out = output_stream ? *output_stream : json_output_stream;
+			ParsingChain processing_chain = create_processing_chain(vm, model_runner, parsers);
+			if (use_stream)
+				std::ifstream{file, std::ios_base::binary} | processing_chain | out;
+			else
+				std::filesystem::path{file} | processing_chain | out;
+		}
+		catch (const std::exception& e)
+		{
+			error_message = errors::diagnostic_message(e);
+		}
+		catch (...)
+		{
+			error_message = "Unknown error";
+		}
+		statistics.processed_files++;
+		if (!ec)
+			statistics.processed_bytes += file_size;
+		if (error_message)
+		{
+			statistics.failed_files++;
+			std::cerr << "[ERROR] " << *error_message << " while processing file " + file.string() << std::endl;
+		}
+		if (!output_dir)
+		{
+			boost::json::object result{{"file", file.string()}};
+			if (error_message)
+				result["error"] = *error_message;
+			else
+				result["output"] = json_output_stream.str();
+			std::lock_guard<std::mutex> lock{json_output_mutex};
+			std::cout << boost::json::serialize(result) << std::endl;
+		}
 	};
 
+	std::vector<std::thread> workers;
+	for (std::optional<ref_or_owned<ChainElement>>& parsers : workers_parsers)
+	{
+		workers.emplace_back([&queue, &parsers, &process_file]()
+		{
+			while (std::optional<std::filesystem::path> file = queue.pop())
+				process_file(parsers, *file);
+		});
+	}
+
+	auto start_time = std::chrono::steady_clock::now();
+	std::atomic<bool> finished{false};
+	std::mutex progress_mutex;
+	std::condition_variable progress_cv;
+	std::thread progress_reporter{[&]()
+	{
+		std::unique_lock<std::mutex> lock{progress_mutex};
+		while (!progress_cv.wait_for(lock, std::chrono::seconds(5), [&]() { return finished.load(); }))
+			report_batch_progress(statistics, queue.size(), start_time);
+	}};
+
+	try
+	{
+		if (input_dir)
+		{
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(*input_dir))
+				if (entry.is_regular_file())
+					queue.push(entry.path());
+		}
+		else
+		{
+			std::string input_list = vm["input-list"].as<std::string>();
+			std::ifstream input_list_file;
+			if (input_list != "-")
+			{
+				input_list_file.open(input_list);
+				throw_if (!input_list_file.good(), "Cannot open input list", input_list);
+			}
+			std::istream& input_list_stream = input_list == "-" ? std::cin : input_list_file;
+			std::string line;
+			while (std::getline(input_list_stream, line))
+				if (!line.empty())
+					queue.push(line);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "[ERROR] " << errors::diagnostic_message(e) << std::endl;
+		statistics.failed_files++;
+	}
+	queue.close();
+	for (auto& worker : workers)
+		worker.join();
+	{
+		std::lock_guard<std::mutex> lock{progress_mutex};
+		finished = true;
+	}
+	progress_cv.notify_one();
+	progress_reporter.join();
+	report_batch_progress(statistics, queue.size(), start_time);
+	return statistics.failed_files > 0 ? 2 : 0;
+}
+
+static int process_single_file(const po::variables_map& vm, bool use_stream)
+{
+	if (!vm.count("input-file"))
+	{
+		std::cerr << "Error: the option '--input-file' is required but missing" << std::endl;
+		return 1;
+	}
+
+	std::string file_name = vm["input-file"].as<std::string>();
+
+	docwire_log_vars(use_stream, file_name);
+	std::optional<ParsingChain> processing_chain;
+	std::optional<ref_or_owned<ChainElement>> parsers;
+	try
+	{
+		processing_chain.emplace(create_processing_chain(vm, create_model_runner(vm), parsers));
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << "Error: " << errors::diagnostic_message(e) << std::endl;
+		return 1;
+	}
+
 	try
 	{
-		chain |= std::cout;
+		if (use_stream)
+			std::ifstream{file_name, std::ios_base::binary} | *processing_chain | std::cout;
+		else
+			std::filesystem::path{file_name} | *processing_chain | std::cout;
 	}
 	catch (const std::exception& e)
 	{
@@ -405,11 +621,122 @@ int main(int argc, char* argv[])
 			"processing file " + file_name << std::endl;
 		return 2;
 	}
-  catch (...)
-  {
+	catch (...)
+	{
 		std::cerr << "[ERROR] Unknown error\nprocessing file " + file_name << std::endl;
 		return 2;
-  }
+	}
+
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	bool local_processing;
+	bool use_stream;
+
+	po::options_description desc("Allowed options");
+	desc.add_options()
+		("help", "display help message")
+		("version", "display DocWire version")
+		("verbose", "enable verbose logging")
+		("profile", "measure time spent in every processing chain element and print the report to standard error")
+		("input-file", po::value<std::string>(), "path to file to process")
+		("input-dir", po::value<std::string>(), "path to directory with files to process in batch mode (recursively)")
+		("input-list", po::value<std::string>(), "path to file with list of files to process in batch mode, one per line (\"-\" for standard input)")
+		("output-dir", po::value<std::string>(), "directory for batch mode results (JSON lines are written to standard output if not specified)")
+		("workers", po::value<unsigned int>(), "number of batch mode worker threads (number of hardware threads by default)")
+		("output_type", po::value<OutputType>()->default_value(OutputType::plain_text), enum_names_str<OutputType>().c_str())
+		("http-post", po::value<std::string>(), "url to process data via http post")
+		("local-ai-prompt", po::value<std::string>(), "prompt to process text via local AI model")
+		("local-ai-model", po::value<std::string>(), "path to local AI model data (build-in default model is used if not specified)")
+		("openai-chat", po::value<std::string>(), "prompt to process text and images via OpenAI")
+		("openai-extract-entities", "extract entities from text and images via OpenAI")
+		("openai-extract-keywords", po::value<unsigned int>(), "extract N keywords/key phrases from text and images via OpenAI")
+		("openai-summarize", "summarize text and images via OpenAI")
+		("openai-detect-sentiment", "detect sentiment of text and images via OpenAI")
+		("openai-analyze-data", "analyze text and images for inportant insights and generate conclusions via OpenAI")
+		("openai-classify", po::value<std::vector<std::string>>()->multitoken(), "classify text and images via OpenAI to one of specified categories")
+		("openai-translate-to", po::value<std::string>(), "language to translate text and images to via OpenAI")
+		("openai-find", po::value<std::string>(), "find phrase, object or event in text and images via OpenAI")
+		("openai-text-to-speech", "convert text to speech via OpenAI")
+		("openai-transcribe", "convert speech to text (transcribe) via OpenAI")
+		("openai-key", po::value<std::string>()->default_value(""), "OpenAI API key")
+		("openai-model", po::value<openai::Model>()->default_value(openai::Model::gpt35_turbo), enum_names_str<openai::Model>().c_str())
+		("openai-tts-model", po::value<openai::TextToSpeech::Model>()->default_value(openai::TextToSpeech::Model::tts1), enum_names_str<openai::TextToSpeech::Model>().c_str())
+		("openai-voice", po::value<openai::TextToSpeech::Voice>()->default_value(openai::TextToSpeech::Voice::alloy), enum_names_str<openai::TextToSpeech::Voice>().c_str())
+		("openai-temperature", po::value<float>(), "force specified temperature for OpenAI prompts")
+		("openai-image-detail", po::value<openai::ImageDetail>()->default_value(openai::ImageDetail::automatic), enum_names_str<openai::ImageDetail>().c_str())
+		("language", po::value<std::vector<Language>>()->default_value({Language::eng}, "eng"), "Set the document language(s) for OCR as ISO 639-3 identifiers like: spa, fra, deu, rus, chi_sim, chi_tra etc. More than 100 languages are supported. Multiple languages can be enabled.")
+		("local-processing", po::value<bool>(&local_processing)->default_value(true), "process documents locally including OCR")
+		("use-stream", po::value<bool>(&use_stream)->default_value(false), "pass file stream to SDK instead of filename")
+		("min_creation_time", po::value<unsigned int>(), "filter emails by min creation time")
+		("max_creation_time", po::value<unsigned int>(), "filter emails by max creation time")
+		("max_nodes_number", po::value<unsigned int>(), "filter by max number of nodes")
+		("folder_name", po::value<std::string>(), "filter emails by folder name")
+		("attachment_extension", po::value<std::string>(), "filter by attachment type")
+		("log_file", po::value<std::string>(), "set path to log file")
+	;
+
+	po::positional_options_description pos_desc;
+	pos_desc.add("input-file", -1);
+
+	po::variables_map vm;
+	try
+	{
+		po::store(po::command_line_parser(argc, argv).options(desc).positional(pos_desc).run(), vm);
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+
+	if (vm.count("help"))
+	{
+		readme();
+		std::cout << std::endl << "Usage: docwire [options] file_name" << std::endl <<
+			"       docwire [options] --input-dir directory|--input-list list_file" << std::endl << std::endl << desc << std::endl;
+		return 0;
+	}
+
+	if (vm.count("version"))
+	{
+		version();
+		return 0;
+	}
+
+	try
+	{
+		po::notify(vm);
+	}
+	catch(const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	if (vm.count("verbose"))
+	{
+		set_log_verbosity(debug);
+	}
+
+	std::unique_ptr<std::ostream> log_stream;
+	if (vm.count("log_file"))
+	{
+		log_stream = std::make_unique<std::ofstream>(vm["log_file"].as<std::string>());
+		set_log_stream(log_stream.get());
+	}
+
+	if (vm.count("profile"))
+		profiling::enable();
+
+	int result = vm.count("input-dir") || vm.count("input-list") ?
+		process_batch(vm, use_stream) :
+		process_single_file(vm, use_stream);
+
+	if (vm.count("profile"))
+		profiling::write_report(std::clog);
 
-  return 0;
+	return result;
 }
@@ -36,6 +36,7 @@
 #include "plain_text_writer.h"
 #include "html_exporter.h"
 #include "parsing_chain.h"
+#include "profiling.h"
 #include "summarize.h"
 #include "text_to_speech.h"
 #include "transcribe.h"
@@ -0,0 +1,35 @@
+/*********************************************************************************************************************************************/
+/*  DocWire SDK: Award-winning modern data processing in C++20. SourceForge Community Choice & Microsoft support. AI-driven processing.      */
+/*  Supports nearly 100 data formats, including email boxes and OCR. Boost efficiency in text extraction, web data extraction, data mining,  */
+/*  document analysis. Offline processing possible for security and confidentiality                                                          */
+/*                                                                                                                                           */
+/*  Copyright (c) SILVERCODERS Ltd, http://silvercoders.com                                                                                  */
+/*  Project homepage: https://github.com/docwire/docwire                                                                                     */
+/*                                                                                                                                           */
+/*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
+/*********************************************************************************************************************************************/
+
+
+#ifndef DOCWIRE_FLUSH_THRESHOLD_H
+#define DOCWIRE_FLUSH_THRESHOLD_H
+
+#include <cstddef>
+#include <optional>
+
+namespace docwire
+{
+
+/**
+ * @brief Streaming mode of exporters.
+ *
+ * If set, exporter emits rendered output as a sequence of data_source tags as soon as at least v bytes are buffered,
+ * instead of a single data_source tag after the whole document is processed. Output chain element writes all of them
+ * to the output stream in order, so output is available earlier and memory usage does not depend on document size.
+ * Elements that expect the whole document in one data_source (like http::Post or AI elements) should not be used
+ * after exporter in streaming mode.
+ */
+struct flush_threshold { std::optional<size_t> v; };
+
+} // namespace docwire
+
+#endif //DOCWIRE_FLUSH_THRESHOLD_H
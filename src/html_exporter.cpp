@@ -20,12 +20,18 @@ namespace docwire
 template<>
 struct pimpl_impl<HtmlExporter> : pimpl_impl_base
 {
+	pimpl_impl(flush_threshold flush_threshold)
+		: m_flush_threshold{flush_threshold}
+	{}
+
 	std::shared_ptr<std::stringstream> m_stream;
 	HtmlWriter m_writer;
 	int m_nested_docs_level { 0 };
+	flush_threshold m_flush_threshold;
 };
 
-HtmlExporter::HtmlExporter()
+HtmlExporter::HtmlExporter(flush_threshold flush_threshold)
+	: with_pimpl<HtmlExporter>(flush_threshold)
 {}
 
 void HtmlExporter::process(Info& info)
@@ -52,6 +58,13 @@ void HtmlExporter::process(Info& info)
 			impl().m_stream.reset();
 		}
 	}
+	else if (impl().m_flush_threshold.v && static_cast<size_t>(impl().m_stream->tellp()) >= *impl().m_flush_threshold.v)
+	{
+		Info chunk_info{data_source{seekable_stream_ptr{impl().m_stream}}};
+		emit(chunk_info);
+		info.cancel = chunk_info.cancel;
+		impl().m_stream = std::make_shared<std::stringstream>();
+	}
 }
 
 } // namespace docwire
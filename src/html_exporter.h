@@ -13,18 +13,21 @@
 #define DOCWIRE_HTML_EXPORTER_H
 
 #include "chain_element.h"
+#include "flush_threshold.h"
 
 namespace docwire
 {
 
 /**
  * @brief Exports data to HTML format.
+ *
+ * @see flush_threshold
  */
 class DllExport HtmlExporter: public ChainElement, public with_pimpl<HtmlExporter>
 {
 public:
 
-  HtmlExporter();
+  HtmlExporter(flush_threshold flush_threshold = {});
 
   void process(Info& info) override;
 
@@ -12,20 +12,25 @@
 #include "html_parser.h"
 
 #include <algorithm>
-#include <regex>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/trim.hpp>
+#include "charset_converter.h"
 #include "entities.h"
 #include "htmlcxx/html/Node.h"
 #include "htmlcxx/html/ParserSax.h"
-#include "htmlcxx/html/CharsetConverter.h"
 #include "log.h"
 #include "make_error.h"
 #include "misc.h"
-#include <mutex>
+#include <optional>
 #include "charsetdetect.h"
+#include "collapse_whitespaces.h"
 #include <set>
 #include "tags.h"
+// MSVC does not define __SSE2__, but SSE2 is always available on x64 and enabled by /arch:SSE2 or higher on x86
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DOCWIRE_HTML_SSE2
+#include <immintrin.h>
+#endif
 
 namespace docwire
 {
@@ -45,11 +50,148 @@ struct StrCaseInsensitiveLess
 
 typedef std::set<std::string, StrCaseInsensitiveLess> CaseInsensitiveStringSet;
 
+constexpr bool is_html_whitespace(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+#if defined(__AVX2__) || defined(DOCWIRE_HTML_SSE2)
+
+struct whitespace_masks
+{
+	uint32_t whitespaces; // bit set for every whitespace in the block
+	uint32_t other_than_space; // bit set for every whitespace other than ' '
+};
+
+#if defined(__AVX2__)
+
+constexpr size_t whitespace_block_size = 32;
+
+inline whitespace_masks find_whitespaces(const char* block)
+{
+	__m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+	__m256i spaces = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' '));
+	// '\t'..'\r' after subtracting '\t' are exactly the bytes not greater than 4 (unsigned)
+	__m256i shifted = _mm256_sub_epi8(chars, _mm256_set1_epi8('\t'));
+	__m256i controls = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(4)), shifted);
+	uint32_t control_mask = static_cast<uint32_t>(_mm256_movemask_epi8(controls));
+	return { static_cast<uint32_t>(_mm256_movemask_epi8(spaces)) | control_mask, control_mask };
+}
+
+inline void store_block(char* dest, const char* block)
+{
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)));
+}
+
+#else
+
+constexpr size_t whitespace_block_size = 16;
+
+inline whitespace_masks find_whitespaces(const char* block)
+{
+	__m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+	__m128i spaces = _mm_cmpeq_epi8(chars, _mm_set1_epi8(' '));
+	// '\t'..'\r' after subtracting '\t' are exactly the bytes not greater than 4 (unsigned)
+	__m128i shifted = _mm_sub_epi8(chars, _mm_set1_epi8('\t'));
+	__m128i controls = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted);
+	uint32_t control_mask = static_cast<uint32_t>(_mm_movemask_epi8(controls));
+	return { static_cast<uint32_t>(_mm_movemask_epi8(spaces)) | control_mask, control_mask };
+}
+
+inline void store_block(char* dest, const char* block)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)));
+}
+
+#endif
+
+#endif // __AVX2__ || DOCWIRE_HTML_SSE2
+
+} // anonymous namespace
+
+// Blocks that are already normalized (no whitespace other than single spaces) are recognized with SIMD
+// and copied as a whole; only blocks that need changes are processed byte by byte.
+void collapse_whitespaces(std::string& text)
+{
+	char* const begin = text.data();
+	const char* const end = begin + text.size();
+	const char* read = begin;
+	char* write = begin;
+	bool previous_was_whitespace = false;
+	auto collapse = [&](const char* until)
+	{
+		for (; read < until; ++read)
+		{
+			if (is_html_whitespace(*read))
+			{
+				if (!previous_was_whitespace)
+					*write++ = ' ';
+				previous_was_whitespace = true;
+			}
+			else
+			{
+				*write++ = *read;
+				previous_was_whitespace = false;
+			}
+		}
+	};
+#if defined(__AVX2__) || defined(DOCWIRE_HTML_SSE2)
+	while (end - read >= static_cast<std::ptrdiff_t>(whitespace_block_size))
+	{
+		whitespace_masks masks = find_whitespaces(read);
+		uint32_t repeated = masks.whitespaces & ((masks.whitespaces << 1) | (previous_was_whitespace ? 1u : 0u));
+		if ((masks.other_than_space | repeated) == 0)
+		{
+			if (write != read)
+				store_block(write, read);
+			write += whitespace_block_size;
+			read += whitespace_block_size;
+			previous_was_whitespace = (masks.whitespaces >> (whitespace_block_size - 1)) & 1;
+		}
+		else
+			collapse(read + whitespace_block_size);
+	}
+#endif
+	collapse(end);
+	text.resize(write - begin);
+}
+
+namespace
+{
+
 bool str_iequals(const std::string& lhs, const std::string& rhs)
 {
 	return strcasecmp(lhs.c_str(), rhs.c_str()) == 0;
 }
 
+// XML declaration is allowed only at the beginning of the document (after optional BOM and whitespaces)
+constexpr size_t xml_declaration_search_limit = 1024;
+
+// <meta> elements are searched only at the beginning of the document, so documents without head are not scanned whole
+constexpr size_t head_search_limit = 256 * 1024;
+
+bool istarts_with(std::string_view text, std::string_view prefix)
+{
+	return text.size() >= prefix.size() && std::equal(prefix.begin(), prefix.end(), text.begin(),
+		[](char a, char b) { return std::tolower((unsigned char)a) == std::tolower((unsigned char)b); });
+}
+
+/**
+ * Part of the document that can contain <meta> elements: everything before </head> or <body>,
+ * limited to head_search_limit bytes.
+ */
+std::string_view document_head(std::string_view html)
+{
+	std::string_view searched = html.substr(0, head_search_limit);
+	for (size_t pos = searched.find('<'); pos != std::string_view::npos; pos = searched.find('<', pos + 1))
+	{
+		std::string_view tag = searched.substr(pos);
+		if (istarts_with(tag, "<body") || istarts_with(tag, "</head"))
+			return searched.substr(0, pos);
+	}
+	return searched;
+}
+
 attributes::Styling html_node_styling(const Node& node)
 {
 	attributes::Styling styling;
@@ -76,7 +218,7 @@ attributes::Styling html_node_styling(const Node& node)
 class SaxParser : public ParserSax
 {
 	private:
-		std::string& m_html_content;
+		std::string_view m_html_content;
 		bool m_in_title;
 		bool m_in_style;
 		bool m_in_script;
@@ -84,7 +226,7 @@ class SaxParser : public ParserSax
 		bool m_turn_off_ol_enumeration;
 		std::string m_style_text;
 		std::string m_charset;
-		htmlcxx::CharsetConverter* m_converter;
+		std::optional<charset_converter> m_converter;
 		char* m_decoded_buffer;	//for decoding html entities
 		size_t m_decoded_buffer_size;
 		bool m_skip_decoding;
@@ -97,7 +239,7 @@ class SaxParser : public ParserSax
 			if (!m_skip_decoding)
 			{
 				if (m_converter)
-					text = m_converter->convert(text);
+					text = m_converter->to_utf8(text);
 			}
 			// warning TODO: Check if libxml2 provides such a functionality. Similar function in html library does not work for some entities
 			if (m_decoded_buffer_size < text.length() * 2 + 1)
@@ -116,16 +258,15 @@ class SaxParser : public ParserSax
 
 		void createCharsetConverter()
 		{
-			if (!m_skip_decoding && m_converter == nullptr && m_charset != "utf-8" && m_charset != "UTF-8")
+			if (!m_skip_decoding && !m_converter && m_charset != "utf-8" && m_charset != "UTF-8")
 			{
 				try
 				{
-					m_converter = new htmlcxx::CharsetConverter(m_charset, "UTF-8");
+					m_converter.emplace(m_charset);
 				}
-				catch (htmlcxx::CharsetConverter::Exception& ex)
+				catch (const std::exception& e)
 				{
-					m_parser->sendTag(errors::make_nested_ptr(ex, make_error("Cannot create charset to UTF-8 converter", m_charset)));
-					m_converter = nullptr;
+					m_parser->sendTag(errors::make_nested_ptr(e, make_error("Cannot convert text to UTF-8", m_charset)));
 				}
 			}
 		}
@@ -439,7 +580,7 @@ class SaxParser : public ParserSax
 						const char* res = nullptr;
 						try
 						{
-							csd_consider(charset_detector, m_html_content.c_str(), static_cast<int>(m_html_content.length()));
+							csd_consider(charset_detector, m_html_content.data(), static_cast<int>(m_html_content.length()));
 							res = csd_close(charset_detector);
 							charset_detector = (csd_t)-1;
 						}
@@ -523,12 +664,7 @@ class SaxParser : public ParserSax
 				return;
 			// https://developer.mozilla.org/en-US/docs/Web/API/Document_Object_Model/Whitespace#what_is_whitespace
 			// Convert all whitespaces into spaces and reduce all adjacent spaces into a single space
-			{
-				static std::mutex whitespaces_regex_mutex;
-				std::lock_guard<std::mutex> whitespaces_regex_mutex_lock(whitespaces_regex_mutex);
-				static const std::regex whitespaces_regex(R"(\s+)");
-				text = std::regex_replace(text, whitespaces_regex, " ");
-			}
+			collapse_whitespaces(text);
 			docwire_log(debug) << "After converting and reducing whitespaces: [" << text << "]";
 			bool last_char_was_space = isspace((unsigned char)m_last_char_in_inline_formatting_context);
 			docwire_log(debug) << "Last char in inline formatting context was whitespace: " << last_char_was_space;
@@ -553,12 +689,13 @@ class SaxParser : public ParserSax
 		{
 			//if this is xhtml document, information about encoding may be stored between <?xml and ?>.
 			//htmlcxx seems not to parse this fragment, so I should do this manually
-			size_t initial_xml_start_pos = m_html_content.find("<?xml");
-			size_t initial_xml_end_pos = m_html_content.find("?>");
-			if (initial_xml_start_pos != std::string::npos && initial_xml_end_pos != std::string::npos
-					&& initial_xml_end_pos > initial_xml_start_pos && initial_xml_end_pos < m_html_content.length())
+			std::string_view prolog = m_html_content.substr(0, xml_declaration_search_limit);
+			size_t initial_xml_start_pos = prolog.find("<?xml");
+			size_t initial_xml_end_pos = initial_xml_start_pos == std::string_view::npos ?
+				std::string_view::npos : prolog.find("?>", initial_xml_start_pos);
+			if (initial_xml_end_pos != std::string_view::npos)
 			{
-				std::string initial_xml = m_html_content.substr(initial_xml_start_pos, initial_xml_end_pos - initial_xml_start_pos);
+				std::string initial_xml{prolog.substr(initial_xml_start_pos, initial_xml_end_pos - initial_xml_start_pos)};
 				std::transform(initial_xml.begin(), initial_xml.end(), initial_xml.begin(), ::tolower);
 
 				size_t encoding_pos = initial_xml.find("encoding");
@@ -583,8 +720,8 @@ class SaxParser : public ParserSax
 		}
 
 	public:
-		SaxParser(std::string& html_content, bool skip_decoding, const HTMLParser* parser)
-			: m_in_title(false), m_in_style(false), m_converter(nullptr), m_decoded_buffer(nullptr),
+		SaxParser(std::string_view html_content, bool skip_decoding, const HTMLParser* parser)
+			: m_in_title(false), m_in_style(false), m_decoded_buffer(nullptr),
 			m_in_script(false), m_decoded_buffer_size(0),
 			  m_turn_off_ul_enumeration(false), m_turn_off_ol_enumeration(false),
 			  m_html_content(html_content), m_skip_decoding(skip_decoding), m_parser(parser), m_last_char_in_inline_formatting_context('\0')
@@ -595,8 +732,6 @@ class SaxParser : public ParserSax
 		{
 			if (m_decoded_buffer)
 				delete[] m_decoded_buffer;
-			if (m_converter)
-				delete m_converter;
 		}
 };
 
@@ -671,20 +806,22 @@ void
 HTMLParser::parse(const data_source& data)
 {
 	docwire_log(debug) << "Using HTML parser.";
-	std::string content = data.string();
+	std::span<const std::byte> span = data.span();
+	std::string_view content{reinterpret_cast<const char*>(span.data()), span.size()};
 	sendTag(tag::Document
 		{
-			.metadata = [this, &content]()
+			.metadata = [content]()
 			{
 				docwire_log(debug) << "Extracting metadata.";
 				attributes::Metadata meta;
 				MetaSaxParser parser(meta);
-				parser.parse(content);
-				return meta;				
+				std::string_view head = document_head(content);
+				parser.parse(head.data(), head.data() + head.size());
+				return meta;
 			}
 		});
 	SaxParser parser(content, impl().m_skip_decoding, this);
-	parser.parse(content);
+	parser.parse(content.data(), content.data() + content.size());
 	sendTag(tag::CloseDocument{});
 }
 
@@ -9,12 +9,9 @@
 /*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
 /*********************************************************************************************************************************************/
 
-#include <memory>
 #include "html_writer.h"
-#include <map>
 #include "misc.h"
-#include <numeric>
-#include <sstream>
+#include <string_view>
 
 namespace docwire
 {
@@ -22,61 +19,77 @@ namespace docwire
 namespace
 {
 
-std::string to_space_separated(const std::vector<std::string>& v)
+/**
+ * Writes value with HTML special characters replaced by entities. Runs of characters that need no escaping
+ * are written in one call, so the value is scanned once and nothing is allocated.
+ */
+void write_encoded(std::ostream& stream, std::string_view value)
 {
-  return v.empty() ? std::string{} :
-    std::accumulate(v.begin()+1, v.end(), v.front(),
-                    [](const std::string& s, const auto& i) { return s + " " + i; });
+  constexpr std::string_view special_chars { "&\"'<>" };
+  size_t run_start = 0;
+  for (size_t pos = value.find_first_of(special_chars); pos != std::string_view::npos; pos = value.find_first_of(special_chars, run_start))
+  {
+    stream.write(value.data() + run_start, pos - run_start);
+    switch(value[pos])
+    {
+      case '&': stream << "&amp;"; break;
+      case '\"': stream << "&quot;"; break;
+      case '\'': stream << "&apos;"; break;
+      case '<': stream << "&lt;"; break;
+      case '>': stream << "&gt;"; break;
+    }
+    run_start = pos + 1;
+  }
+  stream.write(value.data() + run_start, value.size() - run_start);
 }
 
-using HtmlAttrs = std::map<std::string, std::string>;
+void write_attribute(std::ostream& stream, std::string_view name, std::string_view value)
+{
+  stream << ' ' << name << "=\"";
+  write_encoded(stream, value);
+  stream << '"';
+}
 
-HtmlAttrs styling_attributes(const attributes::Styling& styling)
+void write_class_attribute(std::ostream& stream, const attributes::Styling& styling)
 {
-  HtmlAttrs attrs;
-  if (!styling.classes.empty())
-    attrs.insert({"class", to_space_separated(styling.classes)});
-  if (!styling.id.empty())
-    attrs.insert({"id", styling.id});
-  if (!styling.style.empty())
-    attrs.insert({"style", styling.style});
-  return attrs;
+  if (styling.classes.empty())
+    return;
+  stream << " class=\"";
+  for (auto it = styling.classes.begin(); it != styling.classes.end(); ++it)
+  {
+    if (it != styling.classes.begin())
+      stream << ' ';
+    write_encoded(stream, *it);
+  }
+  stream << '"';
 }
 
-template<attributes::WithStyling T>
-HtmlAttrs styling_attributes(const T& tag)
+void write_id_attribute(std::ostream& stream, const attributes::Styling& styling)
 {
-  return styling_attributes(tag.styling);
+  if (!styling.id.empty())
+    write_attribute(stream, "id", styling.id);
 }
 
-std::string encoded(const std::string& value)
+void write_style_attribute(std::ostream& stream, const attributes::Styling& styling)
 {
-  std::string encoded;
-  encoded.reserve(value.size());
-  for (auto& ch: value)
-  {
-    switch(ch)
-    {
-      case '&': encoded += "&amp;"; break;
-      case '\"': encoded += "&quot;"; break;
-      case '\'': encoded += "&apos;"; break;
-      case '<': encoded += "&lt;"; break;
-      case '>': encoded += "&gt;"; break;
-      default: encoded += ch; break;
-    }
-  }
-  return encoded;
+  if (!styling.style.empty())
+    write_attribute(stream, "style", styling.style);
 }
 
-std::string to_string(const HtmlAttrs& attrs)
+// Attributes are written in alphabetical order of their names.
+void write_tag_with_styling(std::ostream& stream, std::string_view tag_name, const attributes::Styling& styling)
 {
-  return std::accumulate(attrs.begin(), attrs.end(), std::string{},
-    [](const std::string &attrs_string, const auto &a){return attrs_string + " " + a.first + "=\"" + encoded(a.second) + "\""; });
+  stream << '<' << tag_name;
+  write_class_attribute(stream, styling);
+  write_id_attribute(stream, styling);
+  write_style_attribute(stream, styling);
+  stream << '>';
 }
 
-std::shared_ptr<TextElement> tag_with_attributes(const std::string& tag_name, const HtmlAttrs& attributes)
+template<attributes::WithStyling T>
+void write_tag_with_styling(std::ostream& stream, std::string_view tag_name, const T& tag)
 {
-  return std::make_shared<TextElement>("<" + tag_name + to_string(attributes) + ">");
+  write_tag_with_styling(stream, tag_name, tag.styling);
 }
 
 } // anonymous namespace
@@ -87,137 +100,148 @@ struct pimpl_impl<HtmlWriter> : pimpl_impl_base
   bool m_header_is_open { false };
   int m_nested_docs_counter { 0 };
 
-  std::shared_ptr<TextElement>
-  write_open_header(const tag::Document& document)
+  void write_open_header(const tag::Document& document, std::ostream& stream)
   {
-    std::string header = {"<!DOCTYPE html>\n"
+    stream << "<!DOCTYPE html>\n"
            "<html>\n"
            "<head>\n"
            "<meta charset=\"utf-8\">\n"
-           "<title>DocWire</title>\n"};
-    std::ostringstream meta_str;
-    write_metadata(document.metadata())->write_to(meta_str);
-    header += meta_str.str();
+           "<title>DocWire</title>\n";
+    write_metadata(document.metadata(), stream);
     m_header_is_open = true;
-    return std::make_shared<TextElement>(header);
   }
 
-  std::shared_ptr<TextElement> write_close_header_open_body()
+  void write_close_header_open_body(std::ostream& stream)
   {
     m_header_is_open = false;
-    return std::make_shared<TextElement>("</head>\n<body>\n");
+    stream << "</head>\n<body>\n";
   }
 
-  std::shared_ptr<TextElement>
-  write_footer()
+  void write_footer(std::ostream& stream)
   {
-    std::string footer = {"</body>\n"
-           "</html>\n"};
-    return std::make_shared<TextElement>(footer);
+    stream << "</body>\n"
+           "</html>\n";
   }
 
-  std::shared_ptr<TextElement> write_link(const tag::Link& link)
+  void write_link(const tag::Link& link, std::ostream& stream)
   {
-    HtmlAttrs attrs = styling_attributes(link);
+    stream << "<a";
+    write_class_attribute(stream, link.styling);
     if (link.url)
-      attrs.insert({"href", *link.url });
-    return tag_with_attributes("a", attrs);
+      write_attribute(stream, "href", *link.url);
+    write_id_attribute(stream, link.styling);
+    write_style_attribute(stream, link.styling);
+    stream << '>';
   }
 
-  std::shared_ptr<TextElement> write_image(const tag::Image& image)
+  void write_image(const tag::Image& image, std::ostream& stream)
   {
-    HtmlAttrs attrs = styling_attributes(image);
-    attrs.insert(
+    stream << "<img";
+    write_attribute(stream, "alt", image.alt ? std::string_view{*image.alt} : std::string_view{});
+    write_class_attribute(stream, image.styling);
+    write_id_attribute(stream, image.styling);
+    write_attribute(stream, "src", image.src);
+    write_style_attribute(stream, image.styling);
+    stream << '>';
+  }
+
+  void write_list(const tag::List& list, std::ostream& stream)
+  {
+    stream << "<ul";
+    write_class_attribute(stream, list.styling);
+    write_id_attribute(stream, list.styling);
+    stream << " style=\"";
+    if (!list.styling.style.empty())
     {
-      { "src", image.src },
-      { "alt", image.alt.value_or("") }
-    });
-    return tag_with_attributes("img", attrs);
+      write_encoded(stream, list.styling.style);
+      stream << "; ";
+    }
+    stream << "list-style-type: ";
+    if (list.type != "decimal" && list.type != "disc" && list.type != "none")
+    {
+      stream << "&quot;";
+      write_encoded(stream, list.type);
+      stream << "&quot;";
+    }
+    else
+      stream << list.type;
+    stream << "\">";
   }
 
-  std::shared_ptr<TextElement> write_list(const tag::List& list)
+  void write_style(const tag::Style& style, std::ostream& stream)
   {
-    HtmlAttrs attrs = styling_attributes(list);
-    std::string orig_style = attrs.count("style") ? attrs["style"] + "; " : "";
-    std::string list_type = list.type;
-    if (list_type != "decimal" && list_type != "disc" && list_type != "none")
-      list_type = '"' + list_type + '"';
-    attrs.insert_or_assign("style", orig_style + "list-style-type: " + list_type);
-    return tag_with_attributes("ul", attrs);
+    stream << "<style type=\"text/css\">" << style.css_text << "</style>\n";
   }
 
-  std::shared_ptr<TextElement> write_style(const tag::Style& style)
+  void write_meta(std::string_view name, std::string_view content, std::ostream& stream)
   {
-    return std::make_shared<TextElement>(
-        "<style type=\"text/css\">" + style.css_text + "</style>\n"/* : ""*/);
+    stream << "<meta name=\"" << name << "\" content=\"";
+    write_encoded(stream, content);
+    stream << "\">\n";
   }
 
-  std::shared_ptr<TextElement> write_metadata(const attributes::Metadata& metadata)
+  void write_metadata(const attributes::Metadata& metadata, std::ostream& stream)
   {
-    std::string meta;
     if (metadata.author)
-      meta += "<meta name=\"author\" content=\"" + encoded(*metadata.author) + "\">\n";
+      write_meta("author", *metadata.author, stream);
     if (metadata.creation_date)
-      meta += "<meta name=\"creation-date\" content=\"" + date_to_string(*metadata.creation_date) + "\">\n";
+      stream << "<meta name=\"creation-date\" content=\"" << date_to_string(*metadata.creation_date) << "\">\n";
     if (metadata.last_modified_by)
-      meta += "<meta name=\"last-modified-by\" content=\"" + encoded(*metadata.last_modified_by) + "\">\n";
+      write_meta("last-modified-by", *metadata.last_modified_by, stream);
     if (metadata.last_modification_date)
-      meta += "<meta name=\"last-modification-date\" content=\"" + date_to_string(*metadata.last_modification_date) + "\">\n";
+      stream << "<meta name=\"last-modification-date\" content=\"" << date_to_string(*metadata.last_modification_date) << "\">\n";
     if (metadata.email_attrs)
     {
-      meta += "<meta name=\"from\" content=\"" + encoded(metadata.email_attrs->from) + "\">\n";
-      meta += "<meta name=\"date\" content=\"" + date_to_string(metadata.email_attrs->date) + "\">\n";
-      meta += "<meta name=\"to\" content=\"" + encoded(*metadata.email_attrs->to) + "\">\n";
-      meta += "<meta name=\"subject\" content=\"" + encoded(*metadata.email_attrs->subject) + "\">\n";
-      meta += "<meta name=\"reply-to\" content=\"" + encoded(*metadata.email_attrs->reply_to) + "\">\n";
-      meta += "<meta name=\"sender\" content=\"" + encoded(*metadata.email_attrs->sender) + "\">\n";
+      write_meta("from", metadata.email_attrs->from, stream);
+      stream << "<meta name=\"date\" content=\"" << date_to_string(metadata.email_attrs->date) << "\">\n";
+      write_meta("to", *metadata.email_attrs->to, stream);
+      write_meta("subject", *metadata.email_attrs->subject, stream);
+      write_meta("reply-to", *metadata.email_attrs->reply_to, stream);
+      write_meta("sender", *metadata.email_attrs->sender, stream);
     }
-    return std::make_shared<TextElement>(meta);
   }
 
   void write_to(const Tag& tag, std::ostream &stream)
   {
     if (!std::holds_alternative<tag::Style>(tag) && !std::holds_alternative<tag::Document>(tag) && !std::holds_alternative<tag::CloseDocument>(tag) && m_header_is_open)
-      write_close_header_open_body()->write_to(stream);
-    std::shared_ptr<TextElement> text_element = std::visit(overloaded {
-      [](const tag::Paragraph& tag) { return tag_with_attributes("p", styling_attributes(tag)); },
-      [](const tag::CloseParagraph& tag) { return std::make_shared<TextElement>("</p>"); },
-      [](const tag::Section& tag) { return tag_with_attributes("div", styling_attributes(tag)); },
-      [](const tag::CloseSection& tag) { return std::make_shared<TextElement>("</div>"); },
-      [](const tag::Span& tag) { return tag_with_attributes("span", styling_attributes(tag)); },
-      [](const tag::CloseSpan& tag) { return std::make_shared<TextElement>("</span>"); },
-      [](const tag::Bold& tag) { return tag_with_attributes("b", styling_attributes(tag)); },
-      [](const tag::CloseBold& tag) { return std::make_shared<TextElement>("</b>"); },
-      [](const tag::Italic& tag) { return tag_with_attributes("i", styling_attributes(tag)); },
-      [](const tag::CloseItalic& tag) { return std::make_shared<TextElement>("</i>"); },
-      [](const tag::Underline& tag) { return tag_with_attributes("u", styling_attributes(tag)); },
-      [](const tag::CloseUnderline& tag) { return std::make_shared<TextElement>("</u>"); },
-      [](const tag::Table& tag) { return tag_with_attributes("table", styling_attributes(tag)); },
-      [](const tag::CloseTable& tag) { return std::make_shared<TextElement>("</table>"); },
-      [](const tag::TableRow& tag) { return tag_with_attributes("tr", styling_attributes(tag)); },
-      [](const tag::CloseTableRow& tag) { return std::make_shared<TextElement>("</tr>"); },
-      [](const tag::TableCell& tag) { return tag_with_attributes("td", styling_attributes(tag)); },
-      [](const tag::CloseTableCell& tag) { return std::make_shared<TextElement>("</td>"); },
-      [](const tag::BreakLine& tag) { return tag_with_attributes("br", styling_attributes(tag)); },
-      [](const tag::Text& tag) { return std::make_shared<TextElement>(tag.text); },
-      [this](const tag::Link& tag) { return write_link(tag); },
-      [](const tag::CloseLink& tag) { return std::make_shared<TextElement>("</a>"); },
-      [this](const tag::Image& tag) { return write_image(tag); },
-      [this](const tag::List& tag) { return write_list(tag); },
-      [](const tag::CloseList& tag) { return std::make_shared<TextElement>("</ul>"); },
-      [](const tag::ListItem& tag) { return std::make_shared<TextElement>("<li>"); },
-      [](const tag::CloseListItem& tag) { return std::make_shared<TextElement>("</li>"); },
-      [](const tag::Header& tag) { return std::make_shared<TextElement>("<header>"); },
-      [](const tag::CloseHeader& tag) { return std::make_shared<TextElement>("</header>"); },
-      [](const tag::Footer& tag) { return std::make_shared<TextElement>("<footer>"); },
-      [](const tag::CloseFooter& tag) { return std::make_shared<TextElement>("</footer>"); },
-      [this](const tag::Document& tag) { m_nested_docs_counter++; return m_nested_docs_counter == 1 ? write_open_header(tag) : std::shared_ptr<TextElement>(); },
-      [this](const tag::CloseDocument& tag) { m_nested_docs_counter--; return m_nested_docs_counter == 0 ? write_footer() : std::shared_ptr<TextElement>(); },
-      [this](const tag::Style& tag) { return write_style(tag); },
-      [](const auto&) { return std::shared_ptr<TextElement>(); }
+      write_close_header_open_body(stream);
+    std::visit(overloaded {
+      [&stream](const tag::Paragraph& tag) { write_tag_with_styling(stream, "p", tag); },
+      [&stream](const tag::CloseParagraph& tag) { stream << "</p>"; },
+      [&stream](const tag::Section& tag) { write_tag_with_styling(stream, "div", tag); },
+      [&stream](const tag::CloseSection& tag) { stream << "</div>"; },
+      [&stream](const tag::Span& tag) { write_tag_with_styling(stream, "span", tag); },
+      [&stream](const tag::CloseSpan& tag) { stream << "</span>"; },
+      [&stream](const tag::Bold& tag) { write_tag_with_styling(stream, "b", tag); },
+      [&stream](const tag::CloseBold& tag) { stream << "</b>"; },
+      [&stream](const tag::Italic& tag) { write_tag_with_styling(stream, "i", tag); },
+      [&stream](const tag::CloseItalic& tag) { stream << "</i>"; },
+      [&stream](const tag::Underline& tag) { write_tag_with_styling(stream, "u", tag); },
+      [&stream](const tag::CloseUnderline& tag) { stream << "</u>"; },
+      [&stream](const tag::Table& tag) { write_tag_with_styling(stream, "table", tag); },
+      [&stream](const tag::CloseTable& tag) { stream << "</table>"; },
+      [&stream](const tag::TableRow& tag) { write_tag_with_styling(stream, "tr", tag); },
+      [&stream](const tag::CloseTableRow& tag) { stream << "</tr>"; },
+      [&stream](const tag::TableCell& tag) { write_tag_with_styling(stream, "td", tag); },
+      [&stream](const tag::CloseTableCell& tag) { stream << "</td>"; },
+      [&stream](const tag::BreakLine& tag) { write_tag_with_styling(stream, "br", tag); },
+      [&stream](const tag::Text& tag) { stream << tag.text; },
+      [this, &stream](const tag::Link& tag) { write_link(tag, stream); },
+      [&stream](const tag::CloseLink& tag) { stream << "</a>"; },
+      [this, &stream](const tag::Image& tag) { write_image(tag, stream); },
+      [this, &stream](const tag::List& tag) { write_list(tag, stream); },
+      [&stream](const tag::CloseList& tag) { stream << "</ul>"; },
+      [&stream](const tag::ListItem& tag) { stream << "<li>"; },
+      [&stream](const tag::CloseListItem& tag) { stream << "</li>"; },
+      [&stream](const tag::Header& tag) { stream << "<header>"; },
+      [&stream](const tag::CloseHeader& tag) { stream << "</header>"; },
+      [&stream](const tag::Footer& tag) { stream << "<footer>"; },
+      [&stream](const tag::CloseFooter& tag) { stream << "</footer>"; },
+      [this, &stream](const tag::Document& tag) { if (++m_nested_docs_counter == 1) write_open_header(tag, stream); },
+      [this, &stream](const tag::CloseDocument& tag) { if (--m_nested_docs_counter == 0) write_footer(stream); },
+      [this, &stream](const tag::Style& tag) { write_style(tag, stream); },
+      [](const auto&) {}
     }, tag);
-    if (text_element)
-      text_element->write_to(stream);
   }
 };
 
@@ -2,10 +2,9 @@ add_library(docwire_mail SHARED eml_parser.cpp pst_parser.cpp)
 
 find_library(bfio bfio REQUIRED)
 find_library(pff pff REQUIRED)
-find_library(htmlcxx htmlcxx REQUIRED)
 find_package(mailio CONFIG REQUIRED)
 find_package(Boost REQUIRED COMPONENTS date_time) # mailio requires it
-target_link_libraries(docwire_mail PRIVATE ${bfio} ${pff} ${htmlcxx} mailio docwire_core)
+target_link_libraries(docwire_mail PRIVATE ${bfio} ${pff} mailio docwire_core)
 
 install(TARGETS docwire_mail)
 if(MSVC)
@@ -13,17 +13,16 @@
 #define DOCWIRE_MAIL_PARSER_H
 
 #include "eml_parser.h"
-#include "parsing_chain.h"
 #include "pst_parser.h"
 
 namespace docwire
 {
 
-class mail_parser : public ParsingChain
+class mail_parser : public parser_dispatcher
 {
     public:
         mail_parser()
-            : ParsingChain{EMLParser{} | PSTParser{}}
+            : parser_dispatcher{{EMLParser{}, PSTParser{}}}
         {}
 };
 
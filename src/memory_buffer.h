@@ -12,6 +12,7 @@
 #ifndef DOCWIRE_MEMORY_BUFFER_H
 #define DOCWIRE_MEMORY_BUFFER_H
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <span>
@@ -27,22 +28,39 @@
   * Using std::vector would introduce unnecessary overhead when only raw buffer access is required.
   * 
   * It is not straightforward to create a std::vector with uninitialized memory, and prefilling it can have a significant performance overhead due to unnecessary initialization when raw buffer access is the primary requirement.
+  *
+  * Growing the buffer allocates geometrically, so appending data in small chunks costs amortized linear time.
   */
 class memory_buffer
 {
 private:
     std::unique_ptr<std::byte[]> m_buffer;
     size_t m_size;
+    size_t m_capacity;
 
-public:
-
-    memory_buffer(size_t size)
+    static std::unique_ptr<std::byte[]> allocate(size_t size)
+    {
 #ifdef __cpp_lib_smart_ptr_for_overwrite
-      : m_buffer{std::make_unique_for_overwrite<std::byte[]>(size)},
+      return std::make_unique_for_overwrite<std::byte[]>(size);
 #else
-      : m_buffer{std::unique_ptr<std::byte[]>(new std::byte[size])},
+      return std::unique_ptr<std::byte[]>(new std::byte[size]);
 #endif
-      m_size{size}
+    }
+
+    void reallocate(size_t new_capacity)
+    {
+      std::unique_ptr<std::byte[]> new_buffer = allocate(new_capacity);
+      std::memcpy(new_buffer.get(), m_buffer.get(), std::min(m_size, new_capacity));
+      m_buffer = std::move(new_buffer);
+      m_capacity = new_capacity;
+    }
+
+public:
+
+    memory_buffer(size_t size)
+      : m_buffer{allocate(size)},
+      m_size{size},
+      m_capacity{size}
     {}
 
     std::byte* data()
@@ -55,11 +73,28 @@ public:
         return m_size;
     }
 
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    /**
+      * @brief Ensures that buffer can grow to the specified size without reallocation.
+      */
+    void reserve(size_t new_capacity)
+    {
+      if (new_capacity > m_capacity)
+        reallocate(new_capacity);
+    }
+
+    /**
+      * @brief Changes size of the buffer. Content up to the smaller of old and new size is preserved,
+      * bytes added at the end are uninitialized.
+      */
     void resize(size_t new_size)
     {
-      std::unique_ptr<std::byte[]> new_buffer = std::make_unique<std::byte[]>(new_size);
-      std::memcpy(new_buffer.get(), m_buffer.get(), std::min(m_size, new_size));
-      m_buffer = std::move(new_buffer);
+      if (new_size > m_capacity)
+        reallocate(std::max(new_size, m_capacity * 2));
       m_size = new_size;
     }
 
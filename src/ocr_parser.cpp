@@ -30,6 +30,8 @@
 #include <mutex>
 #include <numeric>
 #include "resource_path.h"
+#include "resource_pool.h"
+#include <thread>
 #include "throw_if.h"
 
 namespace docwire
@@ -76,6 +78,7 @@ struct pimpl_impl<OCRParser> : with_pimpl_owner<OCRParser>
     std::vector<Language> m_languages;
     ocr_timeout m_ocr_timeout;
     ocr_data_path m_ocr_data_path;
+    ocr_engine_pool_size m_ocr_engine_pool_size;
 
     static bool cancel (void* data, int words)
     {
@@ -188,6 +191,29 @@ std::shared_ptr<PIX> load_pix(const data_source& data)
         });
 }
 
+using tesseract_engine_key = std::pair<std::string, std::string>; // data path and language set
+
+tessAPIWrapper create_tesseract_engine(const tesseract_engine_key& engine_key)
+{
+    tessAPIWrapper api{ new TessBaseAPI{}, tessAPIDeleter };
+    std::lock_guard<std::mutex> tesseract_libtiff_mutex_lock{ tesseract_libtiff_mutex };
+    throw_if (api->Init(engine_key.first.c_str(), engine_key.second.c_str()) != 0,
+        "Could not initialize tesseract", engine_key.first, engine_key.second);
+    return api;
+}
+
+/**
+ * @brief Initialized tesseract engines shared by all OCRParser instances in the process.
+ *
+ * Initialization loads traineddata files and takes longer than recognition of small images,
+ * so engines are reused.
+ */
+resource_pool<tesseract_engine_key, tessAPIWrapper>& engine_pool()
+{
+    static resource_pool<tesseract_engine_key, tessAPIWrapper> pool;
+    return pool;
+}
+
 ocr_data_path default_tessdata_path()
 {
     std::filesystem::path def_tessdata_path = resource_path("tessdata-fast").string();
@@ -198,25 +224,20 @@ ocr_data_path default_tessdata_path()
 
 } // anonymous namespace
 
-OCRParser::OCRParser(const std::vector<Language>& languages, ocr_timeout ocr_timeout, ocr_data_path ocr_data_path)
+OCRParser::OCRParser(const std::vector<Language>& languages, ocr_timeout ocr_timeout, ocr_data_path ocr_data_path,
+    ocr_engine_pool_size ocr_engine_pool_size)
 {
     impl().m_languages = languages;
     impl().m_ocr_timeout = ocr_timeout;
     impl().m_ocr_data_path = ocr_data_path.v.empty() ? default_tessdata_path() : ocr_data_path;
+    throw_if (ocr_engine_pool_size.v && *ocr_engine_pool_size.v == 0,
+        "OCR engine pool size has to be greater than zero", errors::program_logic{});
+    impl().m_ocr_engine_pool_size = ocr_engine_pool_size.v ? ocr_engine_pool_size :
+        docwire::ocr_engine_pool_size{std::max(1u, std::thread::hardware_concurrency())};
 }
 
 std::string OCRParser::parse(const data_source& data, const std::vector<Language>& languages)
 {
-    tessAPIWrapper api{ nullptr, tessAPIDeleter };
-    try
-    {
-        api.reset(new TessBaseAPI{});
-    }
-    catch(const std::bad_alloc& exc)
-    {
-        throw;
-    }
-
     std::string langs = std::accumulate(languages.begin(), languages.end(), std::string{},
       [](const std::string& acc, const Language& lang)
       {
@@ -224,12 +245,6 @@ std::string OCRParser::parse(const data_source& data, const std::vector<Language
       });
     docwire_log_var(langs);
 
-    {
-        std::lock_guard<std::mutex> tesseract_libtiff_mutex_lock{ tesseract_libtiff_mutex };
-        throw_if (api->Init(impl().m_ocr_data_path.v.string().c_str(), langs.c_str()) != 0,
-            "Could not initialize tesseract", impl().m_ocr_data_path.v.string(), langs);
-    }
-
     // Read the image and convert to a gray-scale image
     pix_unique_ptr gray{ nullptr };
 
@@ -266,7 +281,11 @@ std::string OCRParser::parse(const data_source& data, const std::vector<Language
         throw;
     }
 
-    api->SetImage(inverted.get());
+    tesseract_engine_key engine_key{ impl().m_ocr_data_path.v.string(), langs };
+    resource_pool<tesseract_engine_key, tessAPIWrapper>::lease engine =
+        engine_pool().checkout(engine_key, *impl().m_ocr_engine_pool_size.v, create_tesseract_engine);
+    TessBaseAPI& api = **engine;
+    api.SetImage(inverted.get());
     tesseract::ETEXT_DESC monitor;
     if (impl().m_ocr_timeout.v)
     {
@@ -274,10 +293,12 @@ std::string OCRParser::parse(const data_source& data, const std::vector<Language
     }
     monitor.cancel = &pimpl_impl<OCRParser>::cancel;
     monitor.cancel_this = reinterpret_cast<void*>(const_cast<pimpl_impl<OCRParser>*>(&(impl())));
-    api->Recognize(&monitor);
-    auto txt = api->GetUTF8Text();
+    api.Recognize(&monitor);
+    auto txt = api.GetUTF8Text();
     std::string output{ txt };
     delete[] txt;
+    api.Clear();
+    engine.give_back();
     return output;
 }
 
@@ -23,6 +23,7 @@ namespace docwire
 
 struct ocr_data_path { std::filesystem::path v; };
 struct ocr_timeout { std::optional<int32_t> v; };
+struct ocr_engine_pool_size { std::optional<size_t> v; }; //!< maximum tesseract engines per data path and language set, more concurrent parses wait for a free one; number of hardware threads if not set
 
 class DllExport OCRParser : public Parser, public with_pimpl<OCRParser>
 {
@@ -33,7 +34,8 @@ private:
 public:
 
     OCRParser(const std::vector<Language>& languages = {},
-        ocr_timeout ocr_timeout_arg = {}, ocr_data_path ocr_data_path_arg = {});
+        ocr_timeout ocr_timeout_arg = {}, ocr_data_path ocr_data_path_arg = {},
+        ocr_engine_pool_size ocr_engine_pool_size_arg = {});
 
     void parse(const data_source& data) override;
     const std::vector<mime_type> supported_mime_types() override
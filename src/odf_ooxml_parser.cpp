@@ -11,17 +11,22 @@
 
 #include "odf_ooxml_parser.h"
 
+#include "cell_address.h"
 #include "xml_fixer.h"
 #include "zip_reader.h"
 #include "error_tags.h"
 #include <libxml2/libxml/xmlreader.h>
 #include "log.h"
+#include <atomic>
+#include <condition_variable>
 #include <map>
-#include "misc.h"
 #include <mutex>
-#include <regex>
+#include "misc.h"
+#include <optional>
 #include <stdlib.h>
 #include <string.h>
+#include <string_view>
+#include <thread>
 #include "xml_stream.h"
 #include "throw_if.h"
 
@@ -114,38 +119,24 @@ class ODFOOXMLParser::CommandHandlersSet
       }
 			ODFOOXMLParser& p = (ODFOOXMLParser&)parser;
 			int expected_col_num = p.lastOOXMLColNum() + 1;
-			std::string cell_addr_attr = xml_stream.attribute("r");
-			bool matched;
-			std::smatch match;
-			static std::mutex cell_addr_rgx_mutex;
-			{
-				std::lock_guard<std::mutex> cell_addr_rgx_mutex_lock(cell_addr_rgx_mutex);
-				static const std::regex cell_addr_rgx("([A-Z]+)([0-9]+)");
-				matched = std::regex_search(cell_addr_attr, match, cell_addr_rgx);
-			}
-			if (matched && match.size() == 3)
+			std::optional<cell_address> cell_addr = decode_cell_address(xml_stream.attribute("r"));
+			if (cell_addr)
 			{
-				std::string col_addr = match[1].str();
-				std::string row_addr = match[2].str();
-				int col_num = 0;
-				for (char ch: col_addr)
-					col_num = col_num * 26 + (ch - 'A') + 1;
-				int row_num = std::stoi(row_addr);
-				if (col_num > expected_col_num)
+				if (cell_addr->column > expected_col_num)
 				{
-					int empty_cols_count = col_num - expected_col_num;
+					int empty_cols_count = cell_addr->column - expected_col_num;
 					for (int i = 0; i < empty_cols_count; i++)
 					{
 						parser.trySendTag(tag::TableCell{});
 						parser.trySendTag(tag::CloseTableCell{});
 					}
 				}
-				p.setLastOOXMLColNum(col_num);
+				p.setLastOOXMLColNum(cell_addr->column);
 			}
 			else
 			{
 				// we accept when cell address attribute is incorrect or missing
-				p.setLastOOXMLRowNum(expected_col_num);
+				p.setLastOOXMLColNum(expected_col_num);
 			}
       parser.trySendTag(tag::TableCell{});
 			if (xml_stream.attribute("t") == "s")
@@ -240,7 +231,9 @@ class ODFOOXMLParser::CommandHandlersSet
 template<>
 struct pimpl_impl<ODFOOXMLParser> : with_pimpl_owner<ODFOOXMLParser>
 {
-	pimpl_impl(ODFOOXMLParser& owner) : with_pimpl_owner{owner} {}
+	pimpl_impl(ODFOOXMLParser& owner, worksheet_workers workers)
+		: with_pimpl_owner{owner}, m_worksheet_workers{workers} {}
+	worksheet_workers m_worksheet_workers;
 	int last_ooxml_col_num = 0;
 	int last_ooxml_row_num = 0;
 
@@ -374,7 +367,8 @@ struct pimpl_impl<ODFOOXMLParser> : with_pimpl_owner<ODFOOXMLParser>
 	}
 };
 
-ODFOOXMLParser::ODFOOXMLParser()
+ODFOOXMLParser::ODFOOXMLParser(worksheet_workers workers)
+	: with_pimpl<ODFOOXMLParser>(workers)
 {
 		registerODFOOXMLCommandHandler("attrName", &CommandHandlersSet::onOOXMLAttribute);
 		registerODFOOXMLCommandHandler("c", &CommandHandlersSet::onOOXMLCell);
@@ -415,6 +409,116 @@ void ODFOOXMLParser::setLastOOXMLColNum(int c)
 	impl().last_ooxml_col_num = c;
 }
 
+namespace
+{
+
+struct WorksheetResult
+{
+	std::vector<Tag> m_tags;
+	std::exception_ptr m_failure;
+	bool m_ready = false;
+};
+
+} // anonymous namespace
+
+/**
+	Worksheets are inflated and parsed by worker threads, each with its own parser state and zip reader,
+	into separate tag buffers. Shared strings are only read at this point, so all workers use the same table.
+	Worker zip readers use the archive memory of the main reader: data source is already read in full,
+	so it is not modified anymore. Tags are sent to the chain in sheet order from the calling thread
+	and workers do not parse more than a few sheets ahead of it, to limit memory used by buffered tags.
+*/
+void ODFOOXMLParser::parseWorksheetsConcurrently(const ZipReader& zipfile, const std::vector<std::string>& file_names, XmlParseMode mode, unsigned int workers_count)
+{
+	docwire_log_func_with_args(workers_count);
+	const size_t max_sheets_ahead = 2 * workers_count;
+	std::vector<WorksheetResult> results(file_names.size());
+	std::mutex results_mutex;
+	std::condition_variable result_ready;
+	std::condition_variable sheet_sent;
+	size_t sent_sheets = 0;
+	std::atomic<size_t> next_sheet{0};
+	std::atomic<bool> stopped{false};
+	auto worker = [&]()
+	{
+		for (size_t sheet_num = next_sheet++; sheet_num < file_names.size() && !stopped; sheet_num = next_sheet++)
+		{
+			{
+				std::unique_lock<std::mutex> results_lock(results_mutex);
+				sheet_sent.wait(results_lock, [&]() { return sheet_num < sent_sheets + max_sheets_ahead || stopped; });
+			}
+			if (stopped)
+				break;
+			WorksheetResult result;
+			try
+			{
+				ZipReader worker_zipfile{zipfile.data()};
+				worker_zipfile.open();
+				ODFOOXMLParser worker_parser;
+				worker_parser.setXmlOptions(getXmlOptions());
+				worker_parser.shareSharedStrings(*this);
+				worker_parser.bufferTags(&result.m_tags);
+				std::string text;
+				worker_parser.extractText(worker_zipfile, file_names[sheet_num], mode, text);
+			}
+			catch (...)
+			{
+				result.m_failure = std::current_exception();
+			}
+			result.m_ready = true;
+			{
+				std::lock_guard<std::mutex> results_lock(results_mutex);
+				results[sheet_num] = std::move(result);
+			}
+			result_ready.notify_all();
+		}
+	};
+	std::vector<std::thread> threads;
+	auto stop_workers = [&]()
+	{
+		{
+			std::lock_guard<std::mutex> results_lock(results_mutex);
+			stopped = true;
+		}
+		sheet_sent.notify_all();
+		for (auto& thread : threads)
+			thread.join();
+	};
+	try
+	{
+		for (unsigned int i = 0; i < std::min<size_t>(workers_count, file_names.size()); i++)
+			threads.emplace_back(worker);
+		for (size_t sheet_num = 0; sheet_num < file_names.size(); sheet_num++)
+		{
+			WorksheetResult result;
+			{
+				std::unique_lock<std::mutex> results_lock(results_mutex);
+				result_ready.wait(results_lock, [&]() { return results[sheet_num].m_ready; });
+				result = std::move(results[sheet_num]);
+				sent_sheets = sheet_num + 1;
+			}
+			sheet_sent.notify_all();
+			try
+			{
+				if (result.m_failure)
+					std::rethrow_exception(result.m_failure);
+			}
+			catch (const std::exception& e)
+			{
+				std::throw_with_nested(errors::impl{make_pair("file_name", file_names[sheet_num])});
+			}
+			for (Tag& tag : result.m_tags)
+				trySendTag(std::move(tag));
+		}
+	}
+	catch (...)
+	{
+		stop_workers();
+		throw;
+	}
+	stop_workers();
+}
+
 void ODFOOXMLParser::parse(const data_source& data, XmlParseMode mode)
 {
 	ZipReader zipfile{data};
@@ -465,12 +569,12 @@ void ODFOOXMLParser::parse(const data_source& data, XmlParseMode mode)
 	if (main_file_name == "ppt/presentation.xml")
 	{
 		throw_if (!zipfile.loadDirectory());
-		for (int i = 1; zipfile.read("ppt/slides/slide" + int_to_str(i) + ".xml", &content) && i < 2500; i++)
+		for (int i = 1; zipfile.exists("ppt/slides/slide" + int_to_str(i) + ".xml") && i < 2500; i++)
 		{
 			try
 			{
 				std::string text;
-				extractText(content, mode, &zipfile, text);
+				extractText(zipfile, "ppt/slides/slide" + int_to_str(i) + ".xml", mode, text);
 			}
 			catch (const std::exception& e)
 			{
@@ -480,40 +584,41 @@ void ODFOOXMLParser::parse(const data_source& data, XmlParseMode mode)
 	}
 	else if (main_file_name == "xl/workbook.xml")
 	{
-		if (!zipfile.read("xl/sharedStrings.xml", &content))
+		if (!zipfile.exists("xl/sharedStrings.xml"))
 		{
 			//file may not exist, but this is not reason to report an error.
 			docwire_log(debug) << "xl/sharedStrings.xml does not exist";
 		}
 		else
 		{
-			std::string xml;
-			if (mode == FIX_XML)
-			{
-				XmlFixer xml_fixer;
-				xml = xml_fixer.fix(content);
-			}
-			else if (mode == PARSE_XML)
-				xml = content;
-			else
-				throw_if(mode == STRIP_XML, "Stripping XML is not possible for xlsx files", errors::program_logic{});
+			throw_if(mode == STRIP_XML, "Stripping XML is not possible for xlsx files", errors::program_logic{});
 			try
 			{
-				XmlStream xml_stream(xml, getXmlOptions());
-				xml_stream.levelDown();
-				while (xml_stream)
+				std::string xml;
+				std::optional<XmlStream> xml_stream;
+				if (mode == FIX_XML)
+				{
+					throw_if(!zipfile.read("xl/sharedStrings.xml", &content), "Error reading XML file from ZIP file");
+					XmlFixer xml_fixer;
+					xml = xml_fixer.fix(content);
+					xml_stream.emplace(xml, getXmlOptions());
+				}
+				else
+					xml_stream.emplace(zipfile, "xl/sharedStrings.xml", getXmlOptions());
+				xml_stream->levelDown();
+				while (*xml_stream)
 				{
-					if (xml_stream.name() == "si")
+					if (xml_stream->name() == "si")
 					{
-						xml_stream.levelDown();
+						xml_stream->levelDown();
 						SharedString shared_string;
             activeEmittingSignals(false);
-						shared_string.m_text = parseXmlData(xml_stream, mode, &zipfile);
+						shared_string.m_text = parseXmlData(*xml_stream, mode, &zipfile);
             activeEmittingSignals(true);
 						getSharedStrings().push_back(shared_string);
-						xml_stream.levelUp();
+						xml_stream->levelUp();
 					}
-					xml_stream.next();
+					xml_stream->next();
 				}
 			}
 			catch (const std::exception& e)
@@ -521,26 +626,34 @@ void ODFOOXMLParser::parse(const data_source& data, XmlParseMode mode)
 				std::throw_with_nested(errors::impl{std::make_pair("file_name", "xl/sharedStrings.xml")});
 			}
 		}
-		for (int i = 1; zipfile.read("xl/worksheets/sheet" + int_to_str(i) + ".xml", &content); i++)
+		std::vector<std::string> sheet_file_names;
+		for (int i = 1; zipfile.exists("xl/worksheets/sheet" + int_to_str(i) + ".xml"); i++)
+			sheet_file_names.push_back("xl/worksheets/sheet" + int_to_str(i) + ".xml");
+		if (impl().m_worksheet_workers.v > 1 && sheet_file_names.size() > 1)
+			parseWorksheetsConcurrently(zipfile, sheet_file_names, mode, impl().m_worksheet_workers.v);
+		else
 		{
-			try
+			for (const std::string& sheet_file_name : sheet_file_names)
 			{
-				std::string text;
-				extractText(content, mode, &zipfile, text);
-			}
-			catch (const std::exception& e)
-			{
-				std::throw_with_nested(errors::impl{make_pair("file_name", "xl/worksheets/sheet" + int_to_str(i) + ".xml")});
+				try
+				{
+					std::string text;
+					extractText(zipfile, sheet_file_name, mode, text);
+				}
+				catch (const std::exception& e)
+				{
+					std::throw_with_nested(errors::impl{make_pair("file_name", sheet_file_name)});
+				}
 			}
 		}
 	}
 	else
 	{
-		throw_if(!zipfile.read(main_file_name, &content), "Error reading XML file from ZIP file", main_file_name);
+		throw_if(!zipfile.exists(main_file_name), "Error reading XML file from ZIP file", main_file_name);
 		try
 		{
 			std::string text;
-			extractText(content, mode, &zipfile, text);
+			extractText(zipfile, main_file_name, mode, text);
 		}
 		catch (const std::exception& e)
 		{
@@ -634,22 +747,24 @@ attributes::Metadata ODFOOXMLParser::metaData(ZipReader& zipfile) const
 		if (zipfile.exists("ppt/presentation.xml"))
 		{
 			int page_count = 0;
-			for (int i = 1; zipfile.exists("ppt/slides/slide" + int_to_str(i) + ".xml"); i++)
-				page_count++;
+			for (const std::string& file_name : zipfile.list("ppt/slides/slide"))
+				if (file_name.ends_with(".xml"))
+					page_count++;
 			meta.page_count = page_count;
 		}
 		else if (zipfile.exists("content.xml"))
 		{
 			// If we are processing ODP use slide count as page count
 			// If we are processing ODG extract page count the same way
-			std::string content;
-			if (zipfile.read("content.xml", &content) &&
-				(content.find("<office:presentation") != std::string::npos ||
-				content.find("<office:drawing") != std::string::npos))
+			std::string buffer;
+			std::optional<std::span<const char>> data = zipfile.readToBuffer("content.xml", buffer);
+			std::string_view content = data ? std::string_view{data->data(), data->size()} : std::string_view{};
+			if (content.find("<office:presentation") != std::string_view::npos ||
+				content.find("<office:drawing") != std::string_view::npos)
 			{
 				int page_count = 0;
-				std::string page_str = "<draw:page ";
-				for (size_t pos = content.find(page_str); pos != std::string::npos;
+				std::string_view page_str = "<draw:page ";
+				for (size_t pos = content.find(page_str); pos != std::string_view::npos;
 						pos = content.find(page_str, pos + page_str.length()))
 					page_count++;
 				meta.page_count = page_count;
@@ -663,7 +778,8 @@ void
 ODFOOXMLParser::parse(const data_source& data)
 {
 	docwire_log(debug) << "Using ODF/OOXML parser.";
-	with_pimpl<ODFOOXMLParser>::renew_impl();
+	worksheet_workers workers = impl().m_worksheet_workers;
+	with_pimpl<ODFOOXMLParser>::renew_impl(workers);
 	parse(data, XmlParseMode::PARSE_XML);
 }
 
@@ -17,6 +17,12 @@
 namespace docwire
 {
 
+/**
+	Number of threads parsing worksheets of a single XLSX workbook.
+	Values greater than one parse worksheets concurrently and send them to the chain in sheet order.
+*/
+struct worksheet_workers { unsigned int v; };
+
 class DllExport ODFOOXMLParser : public CommonXMLDocumentParser, public with_pimpl<ODFOOXMLParser>
 {
   private:
@@ -28,6 +34,7 @@ class DllExport ODFOOXMLParser : public CommonXMLDocumentParser, public with_pim
     void setLastOOXMLColNum(int c);
     void parse(const data_source& data, XmlParseMode mode);
     attributes::Metadata metaData(ZipReader& zipfile) const;
+    void parseWorksheetsConcurrently(const ZipReader& zipfile, const std::vector<std::string>& file_names, XmlParseMode mode, unsigned int workers_count);
 
 	public:
 
@@ -55,7 +62,7 @@ class DllExport ODFOOXMLParser : public CommonXMLDocumentParser, public with_pim
       };
     };
 
-    ODFOOXMLParser();
+    ODFOOXMLParser(worksheet_workers workers = worksheet_workers{1});
 };
 
 } // namespace docwire
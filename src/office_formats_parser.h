@@ -21,7 +21,6 @@
 #include "xls_parser.h"
 #include "xlsb_parser.h"
 #include "odf_ooxml_parser.h"
-#include "parsing_chain.h"
 #include "ppt_parser.h"
 #include "rtf_parser.h"
 #include "txt_parser.h"
@@ -30,11 +29,11 @@
 namespace docwire
 {
 
-class office_formats_parser : public ParsingChain
+class office_formats_parser : public parser_dispatcher
 {
     public:
         office_formats_parser()
-            : ParsingChain{HTMLParser{} | DOCParser{} | PDFParser{} | XLSParser{} | XLSBParser{} | IWorkParser{} | PPTParser{} | RTFParser{} | ODFOOXMLParser{} | ODFXMLParser{} | XMLParser{} | TXTParser{}}
+            : parser_dispatcher{{HTMLParser{}, DOCParser{}, PDFParser{}, XLSParser{}, XLSBParser{}, IWorkParser{}, PPTParser{}, RTFParser{}, ODFOOXMLParser{}, ODFXMLParser{}, XMLParser{}, TXTParser{}}}
         {}
 };
 
@@ -16,10 +16,37 @@
 #include "log_tags.h" // IWYU pragma: keep
 #include "parsing_chain.h"
 #include "throw_if.h"
+#include <unordered_map>
+#include <unordered_set>
 
 namespace docwire
 {
 
+namespace
+{
+
+std::optional<mime_type> data_source_mime_type(const data_source& data)
+{
+  std::optional<mime_type> mt = data.highest_confidence_mime_type();
+  throw_if(!mt, "Data source has no mime type", errors::uninterpretable_data{});
+  throw_if(data.mime_type_confidence(mime_type { "application/encrypted" }) >= confidence::high, errors::file_encrypted{});
+  return mt;
+}
+
+} // anonymous namespace
+
+template<>
+struct pimpl_impl<Parser> : pimpl_impl_base
+{
+  std::optional<std::unordered_set<mime_type>> m_supported_mime_types;
+};
+
+Parser::Parser() = default;
+
+Parser::Parser(Parser&&) = default;
+
+Parser::~Parser() = default;
+
 void Parser::process(Info &info)
 {
   if (!std::holds_alternative<data_source>(info.tag))
@@ -27,12 +54,14 @@ void Parser::process(Info &info)
     emit(info);
     return;
   }
-  auto data = std::get<data_source>(info.tag);
-  std::optional<mime_type> mt = data.highest_confidence_mime_type();
-  throw_if(!mt, "Data source has no mime type", errors::uninterpretable_data{});
-  throw_if(data.mime_type_confidence(mime_type { "application/encrypted" }) >= confidence::high, errors::file_encrypted{});
-  const std::vector<mime_type>& supported_mimes = supported_mime_types();
-  if (std::find(supported_mimes.begin(), supported_mimes.end(), *mt) == supported_mimes.end())
+  const data_source& data = std::get<data_source>(info.tag);
+  std::optional<mime_type> mt = data_source_mime_type(data);
+  if (!impl().m_supported_mime_types)
+  {
+    const std::vector<mime_type> supported_mimes = supported_mime_types();
+    impl().m_supported_mime_types.emplace(supported_mimes.begin(), supported_mimes.end());
+  }
+  if (!impl().m_supported_mime_types->contains(*mt))
   {
     emit(info);
     return;
@@ -48,14 +77,19 @@ void Parser::process(Info &info)
 }
 
 Info Parser::sendTag(const Tag& tag) const
+{
+  return sendTag(Tag{tag});
+}
+
+Info Parser::sendTag(Tag&& tag) const
 {
   docwire_log_func_with_args(tag);
-  Info info(tag);
-  if (std::holds_alternative<data_source>(tag))
+  Info info{std::move(tag)};
+  if (std::holds_alternative<data_source>(info.tag))
   {
     std::optional<std::reference_wrapper<ParsingChain>> ch = chain();
     throw_if(!ch, "Cannot send datasource to top chain because chain is not assigned", errors::program_logic{});
-    ch->get().top_chain()(tag);
+    ch->get().top_chain().process_in_place(info.tag, [](Tag&) { return continuation::proceed; });
   }
   else
     emit(info);
@@ -67,4 +101,58 @@ Info Parser::sendTag(const Info &info) const
   return sendTag(info.tag);
 }
 
+template<>
+struct pimpl_impl<parser_dispatcher> : pimpl_impl_base
+{
+  pimpl_impl(std::vector<ref_or_owned<Parser>> parsers)
+    : m_parsers{std::move(parsers)}
+  {
+    for (ref_or_owned<Parser>& parser : m_parsers)
+    {
+      for (const mime_type& mt : parser.get().supported_mime_types())
+        m_parsers_by_mime_type.try_emplace(mt, &parser.get());
+    }
+  }
+
+  std::vector<ref_or_owned<Parser>> m_parsers;
+  std::unordered_map<mime_type, Parser*> m_parsers_by_mime_type;
+};
+
+parser_dispatcher::parser_dispatcher(std::vector<ref_or_owned<Parser>> parsers)
+  : with_pimpl<parser_dispatcher>(std::move(parsers))
+{}
+
+void parser_dispatcher::process(Info &info)
+{
+  if (!std::holds_alternative<data_source>(info.tag))
+  {
+    emit(info);
+    return;
+  }
+  std::optional<mime_type> mt = data_source_mime_type(std::get<data_source>(info.tag));
+  auto parser_it = impl().m_parsers_by_mime_type.find(*mt);
+  if (parser_it == impl().m_parsers_by_mime_type.end())
+  {
+    emit(info);
+    return;
+  }
+  Parser& parser = *parser_it->second;
+  std::optional<std::reference_wrapper<ParsingChain>> ch = chain();
+  if (ch)
+    parser.set_chain(ch->get());
+  continuation c = parser.process_in_place(info.tag, [this](Tag& tag)
+  {
+    Info info{std::ref(tag)};
+    emit(info);
+    if (info.cancel)
+      return continuation::stop;
+    else if (info.skip)
+      return continuation::skip;
+    else
+      return continuation::proceed;
+  });
+  info.skip = c == continuation::skip;
+  info.cancel = c == continuation::stop;
+}
+
 } // namespace docwire
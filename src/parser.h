@@ -14,7 +14,9 @@
 #define DOCWIRE_PARSER_H
 
 #include "chain_element.h"
+#include "ref_or_owned.h"
 #include "tags.h"
+#include <vector>
 
 namespace docwire
 {
@@ -22,12 +24,20 @@ namespace docwire
 /**
  * @brief Abstract class for all parsers
  */
-class DllExport Parser : public ChainElement
+class DllExport Parser : public ChainElement, public with_pimpl<Parser>
 {
 public:
+  Parser();
+  Parser(Parser&&);
+  ~Parser();
 
   bool is_leaf() const override { return false; }
 
+  /**
+   * @brief Mime types of data sources handled by the parser, used by parser_dispatcher to index parsers
+   */
+  virtual const std::vector<mime_type> supported_mime_types() = 0;
+
 protected:
 
   /**
@@ -35,12 +45,35 @@ protected:
    */
   virtual void parse(const data_source& data) = 0;
 
-  virtual const std::vector<mime_type> supported_mime_types() = 0;
-
   void process(Info &info) override;
 
   Info sendTag(const Tag& tag) const;
+  Info sendTag(Tag&& tag) const;
   Info sendTag(const Info &info) const;
+
+private:
+  using with_pimpl<Parser>::impl;
+};
+
+/**
+ * @brief Passes data sources directly to the parser supporting their mime type.
+ *
+ * Equivalent of chaining parsers one after another, but supported mime types of all parsers are indexed once,
+ * so dispatch cost does not depend on number of parsers. If more than one parser supports the mime type,
+ * the first one is used. Data sources not supported by any parser and other tags are passed further.
+ */
+class DllExport parser_dispatcher : public ChainElement, public with_pimpl<parser_dispatcher>
+{
+public:
+  explicit parser_dispatcher(std::vector<ref_or_owned<Parser>> parsers);
+
+  bool is_leaf() const override { return false; }
+
+protected:
+  void process(Info &info) override;
+
+private:
+  using with_pimpl<parser_dispatcher>::impl;
 };
 
 } // namespace docwire
@@ -67,9 +67,9 @@ void ParsingChain::operator()(const Tag& tag)
 
 void ParsingChain::process(Info &info)
 {
-  auto rhs_callback = [this](const Tag& tag)
+  auto rhs_callback = [this](Tag& tag)
   {
-    Info info{tag};
+    Info info{std::ref(tag)};
     emit(info);
     if (info.cancel)
       return continuation::stop;
@@ -78,11 +78,11 @@ void ParsingChain::process(Info &info)
     else
       return continuation::proceed;
   };
-  auto lhs_callback = [this, rhs_callback](const Tag& tag)
+  auto lhs_callback = [this, rhs_callback](Tag& tag)
   {
-    return impl().m_rhs_element.get()(tag, rhs_callback);
+    return impl().m_rhs_element.get().process_in_place(tag, rhs_callback);
   };
-  ChainElement::continuation continuation = impl().m_lhs_element.get()(info.tag, lhs_callback);
+  ChainElement::continuation continuation = impl().m_lhs_element.get().process_in_place(info.tag, lhs_callback);
   info.skip = continuation == continuation::skip;
   info.cancel = continuation == continuation::stop;
 }
@@ -12,7 +12,9 @@
 #include "pdf_parser.h"
 
 #include <algorithm>
+#include <atomic>
 #include <codecvt>
+#include <condition_variable>
 #include "data_stream.h"
 #include "error_tags.h"
 #include <iostream>
@@ -27,6 +29,7 @@
 #include <set>
 #include <stdlib.h>
 #include <string.h>
+#include <thread>
 #include "throw_if.h"
 #include <vector>
 #include <zlib.h>
@@ -687,8 +690,10 @@ namespace
 template<>
 struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 {
-	pimpl_impl(PDFParser& owner) : with_pimpl_owner{owner} {}
+	pimpl_impl(PDFParser& owner, pdf_page_workers page_workers)
+		: with_pimpl_owner{owner}, m_page_workers{page_workers} {}
 	PoDoFo::PdfMemDocument m_pdf_document;
+	pdf_page_workers m_page_workers;
 
 	class PredefinedSimpleEncodings : public std::map<std::string, unsigned int*>
 	{
@@ -6887,6 +6892,7 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 		typedef std::map<std::string, Font*> FontsByNames;
 		std::map<unsigned int, Font*> m_fonts_by_indexes;
 		std::vector<Font*> m_fonts;
+		std::vector<std::exception_ptr> m_errors; //!< non-fatal errors collected while parsing, sent to the chain by the emitting thread
 
 		~PDFContent()
 		{
@@ -6899,7 +6905,7 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 	std::shared_ptr<std::istream> m_data_stream;
 	PDFContent m_pdf_content;
 
-  PDFContent::FontsByNames parseFonts(const PoDoFo::PdfPage& page)
+  PDFContent::FontsByNames parseFonts(const PoDoFo::PdfPage& page, PDFContent& pdf_content)
   {
     docwire_log_func();
     PDFContent::FontsByNames fonts_for_page;
@@ -6928,17 +6934,17 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
             {
               docwire_log(debug) << "Font dictionary contains font code";
               auto index = fonts_dictionary->GetKey(font_code)->GetReference().ObjectNumber();
-              if (m_pdf_content.m_fonts_by_indexes.find(index) == m_pdf_content.m_fonts_by_indexes.end())
+              if (pdf_content.m_fonts_by_indexes.find(index) == pdf_content.m_fonts_by_indexes.end())
               {
                 is_new_font = true;
                 font = new PDFContent::Font;
                 font->m_font_dictionary = font_dictionary;
                 fonts_for_page[font_code.GetString()] = font;
-                m_pdf_content.m_fonts_by_indexes[index] = font;
-                m_pdf_content.m_fonts.push_back(font);
+                pdf_content.m_fonts_by_indexes[index] = font;
+                pdf_content.m_fonts.push_back(font);
               }
               else
-                fonts_for_page[font_code.GetString()] = m_pdf_content.m_fonts_by_indexes[index];
+                fonts_for_page[font_code.GetString()] = pdf_content.m_fonts_by_indexes[index];
             }
             else
             {
@@ -6947,7 +6953,7 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
               font = new PDFContent::Font;
               font->m_font_dictionary = font_dictionary;
               fonts_for_page[font_code.GetString()] = font;
-              m_pdf_content.m_fonts.push_back(font);
+              pdf_content.m_fonts.push_back(font);
             }
           }
           catch (std::bad_alloc& ba)
@@ -6960,7 +6966,7 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 
           if (is_new_font)
           {
-            getFontEncoding(*font);
+            getFontEncoding(*font, pdf_content);
             getFontInfo(*font);
           }
         }
@@ -7186,7 +7192,7 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 		}
 	}
 
-	void getFontEncoding(PDFContent::Font& font)
+	void getFontEncoding(PDFContent::Font& font, PDFContent& pdf_content)
 	{
 		docwire_log_func();
 		if (font.m_font_dictionary->HasKey("ToUnicode"))
@@ -7214,7 +7220,7 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 				if (it != m_pdf_cid_to_unicode.end())
 				{
 					font.m_predefined_cmap = true;
-					parsePredefinedCMap(font, it->second);
+					parsePredefinedCMap(font, it->second, pdf_content);
 				}
 			}
 		}
@@ -7270,7 +7276,7 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 		}
 	}
 
-	void parsePredefinedCMap(PDFContent::Font& font, const std::string& cid_to_unicode_cmap)
+	void parsePredefinedCMap(PDFContent::Font& font, const std::string& cid_to_unicode_cmap, PDFContent& pdf_content)
 	{
 		try
 		{
@@ -7287,7 +7293,7 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 				FileStream file_stream(cmap_to_cid_file_name);
 				if (!file_stream.open())
 				{
-					owner().sendTag(make_error_ptr("Cannot open file", cmap_to_cid_file_name));
+					pdf_content.m_errors.push_back(make_error_ptr("Cannot open file", cmap_to_cid_file_name));
 					return;
 				}
 				std::vector<char> buffer(file_stream.size() + 2);
@@ -7437,7 +7443,7 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 			#endif
 			if (!file_stream.open())
 			{
-				owner().sendTag(make_error_ptr("Cannot open file", cid_to_unicode_cmap));
+				pdf_content.m_errors.push_back(make_error_ptr("Cannot open file", cid_to_unicode_cmap));
 				return;
 			}
 			std::vector<char> buffer(file_stream.size() + 2);
@@ -7648,365 +7654,384 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 		return result;
 	}
 
-	void parseText()
+	std::string parsePage(PoDoFo::PdfPage& pdf_page, PDFContent& pdf_content)
 	{
 		docwire_log_func();
-		int page_count = m_pdf_document.GetPages().GetCount();
-		docwire_log_var(page_count);
-		for (size_t page_num = 0; page_num < page_count; page_num++)
-		{
-			docwire_log_var(page_num);
-			auto response = owner().sendTag(tag::Page{});
-			if (response.skip)
-			{
-				continue;
-			}
-			if (response.cancel)
-			{
-				break;
-			}
-			try
-			{
-				PDFContent::PageText page_text;
-				const PoDoFo::PdfFont* pCurFont = nullptr;
-				double curFontSize = -1;
-				PoDoFo::PdfPage* page = &m_pdf_document.GetPages().GetPageAt(page_num);
-				PDFContent::FontsByNames fonts_for_page = parseFonts(*page);
-				PoDoFo::PdfContentStreamReader reader(*page);
-				bool in_text = false;
+		PDFContent::PageText page_text;
+		const PoDoFo::PdfFont* pCurFont = nullptr;
+		double curFontSize = -1;
+		PoDoFo::PdfPage* page = &pdf_page;
+		PDFContent::FontsByNames fonts_for_page = parseFonts(*page, pdf_content);
+		PoDoFo::PdfContentStreamReader reader(*page);
+		bool in_text = false;
 
-				PoDoFo::PdfContent content;
+		PoDoFo::PdfContent content;
 
-				while (reader.TryReadNext(content))
+		while (reader.TryReadNext(content))
+		{
+			docwire_log(debug) << "PdfContentStreamReader::TryReadNext() succeeded";
+			docwire_log_var(content);
+			if (content.Type == PoDoFo::PdfContentType::Operator)
+			{
+				switch (content.Operator)
 				{
-					docwire_log(debug) << "PdfContentStreamReader::TryReadNext() succeeded";
-					docwire_log_var(content);
-					if (content.Type == PoDoFo::PdfContentType::Operator)
+					case PoDoFo::PdfOperator::ET:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::ET";
+						in_text = false;
+						break;
+					}
+					case PoDoFo::PdfOperator::Tm:
 					{
-						switch (content.Operator)
+						docwire_log(debug) << "content.Operator == PdfOperator::Tm";
+						if (!in_text)
+							break;
+						page_text.executeTm(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 6));
+						break;
+					}
+					case PoDoFo::PdfOperator::Td:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::Td";
+						if (!in_text)
+							break;
+						page_text.executeTd(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 2));
+						break;
+					}
+					case PoDoFo::PdfOperator::T_Star:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::T_Star";
+						if (!in_text)
+							break;
+						page_text.executeTstar();
+						break;
+					}
+					case PoDoFo::PdfOperator::TD:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::TD";
+						if (!in_text)
+							break;
+						page_text.executeTD(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 2));
+							break;
+					}
+					case PoDoFo::PdfOperator::TJ:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::TJ";
+						if (!in_text)
+							break;
+						std::vector<PDFContent::TJArrayElement> tj_array;
+						tj_array.reserve(100);
+						const PoDoFo::PdfArray& a = content.Stack[0].GetArray();
+						for (size_t j = 0; j < a.GetSize(); ++j)
 						{
-							case PoDoFo::PdfOperator::ET:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::ET";
-								in_text = false;
-								break;
-							}
-							case PoDoFo::PdfOperator::Tm:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Tm";
-								if (!in_text)
-									break;
-								page_text.executeTm(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 6));
-								break;
-							}
-							case PoDoFo::PdfOperator::Td:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Td";
-								if (!in_text)
-									break;
-								page_text.executeTd(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 2));
-								break;
-							}
-							case PoDoFo::PdfOperator::T_Star:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::T_Star";
-								if (!in_text)
-									break;
-								page_text.executeTstar();
-								break;
-							}
-							case PoDoFo::PdfOperator::TD:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::TD";
-								if (!in_text)
-									break;
-								page_text.executeTD(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 2));
-									break;
-							}
-							case PoDoFo::PdfOperator::TJ:
+							switch (a[j].GetDataType())
 							{
-								docwire_log(debug) << "content.Operator == PdfOperator::TJ";
-								if (!in_text)
-									break;
-								std::vector<PDFContent::TJArrayElement> tj_array;
-								tj_array.reserve(100);
-								const PoDoFo::PdfArray& a = content.Stack[0].GetArray();
-								for (size_t j = 0; j < a.GetSize(); ++j)
+								case PoDoFo::PdfDataType::String:
 								{
-									switch (a[j].GetDataType())
+									tj_array.push_back(PDFContent::TJArrayElement());
+									tj_array[tj_array.size() - 1].m_is_number = false;
+									if (pCurFont)
 									{
-										case PoDoFo::PdfDataType::String:
+										try
 										{
-											tj_array.push_back(PDFContent::TJArrayElement());
-											tj_array[tj_array.size() - 1].m_is_number = false;
-											if (pCurFont)
-											{
-												try
-												{
-													tj_array[tj_array.size() - 1].m_utf_text = encode_to_utf8(a[j].GetString(), *pCurFont);
-												}
-												catch (const std::exception&)
-												{}
-												if (a[j].GetString().IsHex())
-												{
-													tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(a[j].GetString());
-												}
-												else
-												{
-													tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(a[j].GetString());
-												}
-												tj_array[tj_array.size() - 1].m_pdf_string = a[j].GetString();
-											}
-											else
-											{
-												tj_array[tj_array.size() - 1].m_utf_text = a[j].GetString().GetString();
-												if (a[j].GetString().IsHex())
-												{
-													tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(a[j].GetString());
-												}
-												else
-												{
-													tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(a[j].GetString());
-												}
-												tj_array[tj_array.size() - 1].m_pdf_string = a[j].GetString();
-											}
-											break;
+											tj_array[tj_array.size() - 1].m_utf_text = encode_to_utf8(a[j].GetString(), *pCurFont);
 										}
-										case PoDoFo::PdfDataType::Number:
-										case PoDoFo::PdfDataType::Real:
+										catch (const std::exception&)
+										{}
+										if (a[j].GetString().IsHex())
 										{
-											tj_array.push_back(PDFContent::TJArrayElement());
-											tj_array[tj_array.size() - 1].m_is_number = true;
-											tj_array[tj_array.size() - 1].m_value = a[j].GetReal();
-											break;
+											tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(a[j].GetString());
 										}
-									}
-									PDFContent::TJArrayElement& new_element = tj_array[tj_array.size() - 1];
-									docwire_log_var(new_element);
-								}
-								if (pCurFont)
-								{
-									page_text.executeTJ(tj_array, pCurFont, curFontSize);
-								}
-								else
-								{
-									page_text.executeTJ(tj_array);
-								}
-								break;
-							}
-							case PoDoFo::PdfOperator::Tj:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Tj";
-								if (!in_text)
-									break;
-
-								std::vector<PDFContent::TJArrayElement> tj_array;
-								tj_array.push_back(PDFContent::TJArrayElement());
-								tj_array[tj_array.size() - 1].m_is_number = false;
-								if (pCurFont)
-								{
-									auto text = content.Stack[0].GetString();
-									try
-									{
-										tj_array[tj_array.size() - 1].m_utf_text = encode_to_utf8(text, *pCurFont);
-									}
-									catch (const std::exception&)
-									{}
-									tj_array[tj_array.size() - 1].m_pdf_string = text;
-									if (text.IsHex())
-									{
-										tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(text);
-									}
-									else
-									{
-										tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(text);
-									}
-								}
-								else
-								{
-									auto text = content.Stack[0].GetString();
-									tj_array[tj_array.size() - 1].m_utf_text = text.GetString();
-									tj_array[tj_array.size() - 1].m_pdf_string = text;
-									if (text.IsHex())
-									{
-										tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(text);
+										else
+										{
+											tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(a[j].GetString());
+										}
+										tj_array[tj_array.size() - 1].m_pdf_string = a[j].GetString();
 									}
 									else
 									{
-										tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(text);
+										tj_array[tj_array.size() - 1].m_utf_text = a[j].GetString().GetString();
+										if (a[j].GetString().IsHex())
+										{
+											tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(a[j].GetString());
+										}
+										else
+										{
+											tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(a[j].GetString());
+										}
+										tj_array[tj_array.size() - 1].m_pdf_string = a[j].GetString();
 									}
-								}
-								if (pCurFont)
-								{
-									page_text.executeTJ(tj_array, pCurFont, curFontSize);
-								}
-								else{
-									page_text.executeTJ(tj_array);
-								}
-								break;
-							}
-							case PoDoFo::PdfOperator::Tw:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Tw";
-								if (!in_text)
 									break;
-								auto values = pdfvariant_stack_to_vector_of_double(content.Stack, 0, 1);
-								page_text.executeTw(values);
-								if (pCurFont)
-								{
-									//state.WordSpacing = values[0];
 								}
-								break;
-							}
-							case PoDoFo::PdfOperator::Tc:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Tc";
-								if (!in_text)
-									break;
-								auto values = pdfvariant_stack_to_vector_of_double(content.Stack, 0, 1);
-								page_text.executeTc(values);
-								if (pCurFont)
+								case PoDoFo::PdfDataType::Number:
+								case PoDoFo::PdfDataType::Real:
 								{
-									//state.CharSpacing = values[0];
-								}
-								break;
-							}
-							case PoDoFo::PdfOperator::Ts:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Ts";
-								if (!in_text)
+									tj_array.push_back(PDFContent::TJArrayElement());
+									tj_array[tj_array.size() - 1].m_is_number = true;
+									tj_array[tj_array.size() - 1].m_value = a[j].GetReal();
 									break;
-								page_text.executeTs(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 1));
-								break;
-							}
-							case PoDoFo::PdfOperator::Quote:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Quote";
-								if (!in_text)
-									break;
-								if (pCurFont)
-								{
-									page_text.executeQuote(content.Stack[0].GetString().GetString(), pCurFont, curFontSize);
 								}
-								else
-								{
-									page_text.executeQuote(content.Stack[0].GetString().GetString(), pCurFont, curFontSize);
-								}
-								break;
-							}
-							case PoDoFo::PdfOperator::DoubleQuote:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::DoubleQuote";
-								if (!in_text)
-									break;
-								if(pCurFont)
-								{
-									std::string s = content.Stack[0].GetString().GetString();
-									page_text.executeDoubleQuote(s, pdfvariant_stack_to_vector_of_double(content.Stack, 1, 2), pCurFont, curFontSize);
-								}
-								else
-								{
-									page_text.executeDoubleQuote(content.Stack[0].GetString().GetString(), pdfvariant_stack_to_vector_of_double(content.Stack, 1, 2), pCurFont, curFontSize);
-								}
-								break;
 							}
-							case PoDoFo::PdfOperator::Tf:
-							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Tf";
-								if (!in_text)
-									break;
-								long font_size = content.Stack[0].GetReal();
-								std::string font_name = content.Stack[1].GetName().GetString();
-								if (fonts_for_page.find(font_name) != fonts_for_page.end()) {
-									page_text.executeTf(font_size, *(fonts_for_page)[font_name]);
-								}
-								try
-								{
-									std::lock_guard<std::mutex> podofo_freetype_mutex_lock(podofo_freetype_mutex);
-									pCurFont = page->GetResources()->GetFont(font_name);
-								}
-								catch (PoDoFo::PdfError &error)
-								{
-									if (error.GetCode() != PoDoFo::PdfErrorCode::InternalLogic)
-									{
-										throw PoDoFo::PdfError(error);
-									}
-								}
-
-								if (pCurFont)
-								{
-									//state.FontSize = font_size;
-									curFontSize = font_size;
-								}
-								else
-								{
-									owner().sendTag(make_error_ptr("Unknown font"));
-								}
+							PDFContent::TJArrayElement& new_element = tj_array[tj_array.size() - 1];
+							docwire_log_var(new_element);
+						}
+						if (pCurFont)
+						{
+							page_text.executeTJ(tj_array, pCurFont, curFontSize);
+						}
+						else
+						{
+							page_text.executeTJ(tj_array);
+						}
+						break;
+					}
+					case PoDoFo::PdfOperator::Tj:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::Tj";
+						if (!in_text)
+							break;
 
-								break;
-							}
-							case PoDoFo::PdfOperator::BT:
+						std::vector<PDFContent::TJArrayElement> tj_array;
+						tj_array.push_back(PDFContent::TJArrayElement());
+						tj_array[tj_array.size() - 1].m_is_number = false;
+						if (pCurFont)
+						{
+							auto text = content.Stack[0].GetString();
+							try
 							{
-								docwire_log(debug) << "content.Operator == PdfOperator::BT";
-								in_text = true;
-								page_text.executeBT();
-								break;
+								tj_array[tj_array.size() - 1].m_utf_text = encode_to_utf8(text, *pCurFont);
 							}
-							case PoDoFo::PdfOperator::TL:
+							catch (const std::exception&)
+							{}
+							tj_array[tj_array.size() - 1].m_pdf_string = text;
+							if (text.IsHex())
 							{
-								docwire_log(debug) << "content.Operator == PdfOperator::TL";
-								page_text.executeTL(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 1));
-								break;
+								tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(text);
 							}
-							case PoDoFo::PdfOperator::Tz:
+							else
 							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Tz";
-								long scale = content.Stack[0].GetReal();
-								page_text.executeTZ(scale);
-								if (pCurFont) {
-									//state.FontScale = scale;
-								}
-								break;
+								tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(text);
 							}
-							case PoDoFo::PdfOperator::cm:
+						}
+						else
+						{
+							auto text = content.Stack[0].GetString();
+							tj_array[tj_array.size() - 1].m_utf_text = text.GetString();
+							tj_array[tj_array.size() - 1].m_pdf_string = text;
+							if (text.IsHex())
 							{
-								docwire_log(debug) << "content.Operator == PdfOperator::cm";
-								page_text.executeCm(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 6));
-								break;
+								tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(text);
 							}
-							case PoDoFo::PdfOperator::Q:
+							else
 							{
-								docwire_log(debug) << "content.Operator == PdfOperator::Q";
-								page_text.popState();
-								break;
+								tj_array[tj_array.size() - 1].m_text = pdfstring_to_hex(text);
 							}
-							case PoDoFo::PdfOperator::q:
+						}
+						if (pCurFont)
+						{
+							page_text.executeTJ(tj_array, pCurFont, curFontSize);
+						}
+						else{
+							page_text.executeTJ(tj_array);
+						}
+						break;
+					}
+					case PoDoFo::PdfOperator::Tw:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::Tw";
+						if (!in_text)
+							break;
+						auto values = pdfvariant_stack_to_vector_of_double(content.Stack, 0, 1);
+						page_text.executeTw(values);
+						if (pCurFont)
+						{
+							//state.WordSpacing = values[0];
+						}
+						break;
+					}
+					case PoDoFo::PdfOperator::Tc:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::Tc";
+						if (!in_text)
+							break;
+						auto values = pdfvariant_stack_to_vector_of_double(content.Stack, 0, 1);
+						page_text.executeTc(values);
+						if (pCurFont)
+						{
+							//state.CharSpacing = values[0];
+						}
+						break;
+					}
+					case PoDoFo::PdfOperator::Ts:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::Ts";
+						if (!in_text)
+							break;
+						page_text.executeTs(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 1));
+						break;
+					}
+					case PoDoFo::PdfOperator::Quote:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::Quote";
+						if (!in_text)
+							break;
+						if (pCurFont)
+						{
+							page_text.executeQuote(content.Stack[0].GetString().GetString(), pCurFont, curFontSize);
+						}
+						else
+						{
+							page_text.executeQuote(content.Stack[0].GetString().GetString(), pCurFont, curFontSize);
+						}
+						break;
+					}
+					case PoDoFo::PdfOperator::DoubleQuote:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::DoubleQuote";
+						if (!in_text)
+							break;
+						if(pCurFont)
+						{
+							std::string s = content.Stack[0].GetString().GetString();
+							page_text.executeDoubleQuote(s, pdfvariant_stack_to_vector_of_double(content.Stack, 1, 2), pCurFont, curFontSize);
+						}
+						else
+						{
+							page_text.executeDoubleQuote(content.Stack[0].GetString().GetString(), pdfvariant_stack_to_vector_of_double(content.Stack, 1, 2), pCurFont, curFontSize);
+						}
+						break;
+					}
+					case PoDoFo::PdfOperator::Tf:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::Tf";
+						if (!in_text)
+							break;
+						long font_size = content.Stack[0].GetReal();
+						std::string font_name = content.Stack[1].GetName().GetString();
+						if (fonts_for_page.find(font_name) != fonts_for_page.end()) {
+							page_text.executeTf(font_size, *(fonts_for_page)[font_name]);
+						}
+						try
+						{
+							std::lock_guard<std::mutex> podofo_freetype_mutex_lock(podofo_freetype_mutex);
+							pCurFont = page->GetResources()->GetFont(font_name);
+						}
+						catch (PoDoFo::PdfError &error)
+						{
+							if (error.GetCode() != PoDoFo::PdfErrorCode::InternalLogic)
 							{
-								docwire_log(debug) << "content.Operator == PdfOperator::q";
-								page_text.pushState();
-								break;
+								throw PoDoFo::PdfError(error);
 							}
 						}
+
+						if (pCurFont)
+						{
+							//state.FontSize = font_size;
+							curFontSize = font_size;
+						}
+						else
+						{
+							pdf_content.m_errors.push_back(make_error_ptr("Unknown font"));
+						}
+
+						break;
 					}
-					else
+					case PoDoFo::PdfOperator::BT:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::BT";
+						in_text = true;
+						page_text.executeBT();
+						break;
+					}
+					case PoDoFo::PdfOperator::TL:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::TL";
+						page_text.executeTL(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 1));
+						break;
+					}
+					case PoDoFo::PdfOperator::Tz:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::Tz";
+						long scale = content.Stack[0].GetReal();
+						page_text.executeTZ(scale);
+						if (pCurFont) {
+							//state.FontScale = scale;
+						}
+						break;
+					}
+					case PoDoFo::PdfOperator::cm:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::cm";
+						page_text.executeCm(pdfvariant_stack_to_vector_of_double(content.Stack, 0, 6));
+						break;
+					}
+					case PoDoFo::PdfOperator::Q:
 					{
-						docwire_log(debug) << "content.Type != PdfContentType::Operator";
-						// warning TODO throw
+						docwire_log(debug) << "content.Operator == PdfOperator::Q";
+						page_text.popState();
+						break;
+					}
+					case PoDoFo::PdfOperator::q:
+					{
+						docwire_log(debug) << "content.Operator == PdfOperator::q";
+						page_text.pushState();
+						break;
 					}
 				}
-				std::string single_page_text;
-				page_text.getText(single_page_text);
-				single_page_text += "\n\n";
-				auto response = owner().sendTag(tag::Text{single_page_text});
-				if (response.cancel)
+			}
+			else
+			{
+				docwire_log(debug) << "content.Type != PdfContentType::Operator";
+				// warning TODO throw
+			}
+		}
+		std::string single_page_text;
+		page_text.getText(single_page_text);
+		single_page_text += "\n\n";
+		return single_page_text;
+	}
+
+	bool sendPageText(const std::string& page_text, std::vector<std::exception_ptr>& errors)
+	{
+		for (auto& error : errors)
+			owner().sendTag(error);
+		errors.clear();
+		auto response = owner().sendTag(tag::Text{page_text});
+		if (response.cancel)
+		{
+			return false;
+		}
+		auto response2 = owner().sendTag(tag::ClosePage{});
+		if (response2.cancel)
+		{
+			return false;
+		}
+		return true;
+	}
+
+	void parseText()
+	{
+		docwire_log_func();
+		int page_count = m_pdf_document.GetPages().GetCount();
+		docwire_log_var(page_count);
+		for (size_t page_num = 0; page_num < page_count; page_num++)
+		{
+			docwire_log_var(page_num);
+			auto response = owner().sendTag(tag::Page{});
+			if (response.skip)
+			{
+				continue;
+			}
+			if (response.cancel)
+			{
+				break;
+			}
+			try
+			{
+				std::string single_page_text = parsePage(m_pdf_document.GetPages().GetPageAt(page_num), m_pdf_content);
+				if (!sendPageText(single_page_text, m_pdf_content.m_errors))
 				{
 					break;
 				}
-        auto response2 = owner().sendTag(tag::ClosePage{});
-        if (response2.cancel)
-        {
-          break;
-        }
 			}
 			catch (const std::exception& e)
 			{
@@ -8016,6 +8041,122 @@ struct pimpl_impl<PDFParser> : with_pimpl_owner<PDFParser>
 		}
 	}
 
+	/**
+		PoDoFo loads objects and their streams on first access, which modifies the document.
+		Everything that pages can reference is loaded here, so worker threads only read it later.
+	*/
+	void preloadObjects()
+	{
+		docwire_log_func();
+		for (PoDoFo::PdfObject* object : m_pdf_document.GetObjects())
+		{
+			if (object->IsDictionary() && object->HasStream())
+				(void)object->GetStream();
+		}
+	}
+
+	struct PageResult
+	{
+		std::string m_text;
+		std::vector<std::exception_ptr> m_errors;
+		std::exception_ptr m_failure;
+		bool m_ready = false;
+	};
+
+	/**
+		Pages are decoded and laid out by worker threads, each with its own font state.
+		Results are sent to the chain in page order from the calling thread.
+	*/
+	void parseTextConcurrently(unsigned int workers_count)
+	{
+		docwire_log_func_with_args(workers_count);
+		preloadObjects();
+		std::vector<PoDoFo::PdfPage*> pages;
+		int page_count = m_pdf_document.GetPages().GetCount();
+		docwire_log_var(page_count);
+		for (size_t page_num = 0; page_num < page_count; page_num++)
+			pages.push_back(&m_pdf_document.GetPages().GetPageAt(page_num));
+		std::vector<PageResult> results(pages.size());
+		std::mutex results_mutex;
+		std::condition_variable result_ready;
+		std::atomic<size_t> next_page{0};
+		std::atomic<bool> stopped{false};
+		auto worker = [&]()
+		{
+			for (size_t page_num = next_page++; page_num < pages.size() && !stopped; page_num = next_page++)
+			{
+				PageResult result;
+				try
+				{
+					PDFContent pdf_content;
+					result.m_text = parsePage(*pages[page_num], pdf_content);
+					result.m_errors = std::move(pdf_content.m_errors);
+				}
+				catch (...)
+				{
+					result.m_failure = std::current_exception();
+				}
+				result.m_ready = true;
+				{
+					std::lock_guard<std::mutex> results_lock(results_mutex);
+					results[page_num] = std::move(result);
+				}
+				result_ready.notify_all();
+			}
+		};
+		std::vector<std::thread> threads;
+		auto stop_workers = [&]()
+		{
+			stopped = true;
+			for (auto& thread : threads)
+				thread.join();
+		};
+		try
+		{
+			for (unsigned int i = 0; i < std::min<size_t>(workers_count, pages.size()); i++)
+				threads.emplace_back(worker);
+			for (size_t page_num = 0; page_num < pages.size(); page_num++)
+			{
+				docwire_log_var(page_num);
+				auto response = owner().sendTag(tag::Page{});
+				if (response.skip)
+				{
+					continue;
+				}
+				if (response.cancel)
+				{
+					break;
+				}
+				PageResult result;
+				{
+					std::unique_lock<std::mutex> results_lock(results_mutex);
+					result_ready.wait(results_lock, [&]() { return results[page_num].m_ready; });
+					result = std::move(results[page_num]);
+				}
+				try
+				{
+					if (result.m_failure)
+						std::rethrow_exception(result.m_failure);
+					if (!sendPageText(result.m_text, result.m_errors))
+					{
+						break;
+					}
+				}
+				catch (const std::exception& e)
+				{
+					std::throw_with_nested(make_error(page_num));
+				}
+				docwire_log(debug) << "Page processed" << docwire_log_streamable_var(page_num);
+			}
+		}
+		catch (...)
+		{
+			stop_workers();
+			throw;
+		}
+		stop_workers();
+	}
+
 	void parseMetadata(PDFReader& pdf_reader, attributes::Metadata& metadata)
 	{
 		//according to PDF specification, we can extract: author, creation date and last modification date.
@@ -8160,11 +8301,11 @@ pimpl_impl<PDFParser>::PDFReader::OperatorCodes pimpl_impl<PDFParser>::PDFReader
 
 std::mutex podofo_mutex;
 
-PDFParser::PDFParser()
+PDFParser::PDFParser(pdf_page_workers page_workers)
 	: with_pimpl<PDFParser>(nullptr)
 {
 	std::lock_guard<std::mutex> podofo_mutex_lock(podofo_mutex);
-	renew_impl();
+	renew_impl(page_workers);
 }
 
 PDFParser::~PDFParser()
@@ -8187,9 +8328,10 @@ void
 PDFParser::parse(const data_source& data)
 {
 	docwire_log(debug) << "Using PDF parser.";
+	pdf_page_workers page_workers = impl().m_page_workers;
 	{
 		std::lock_guard<std::mutex> podofo_mutex_lock(podofo_mutex);
-		renew_impl();
+		renew_impl(page_workers);
 	}
 	sendTag(tag::Document
 		{
@@ -8199,6 +8341,9 @@ PDFParser::parse(const data_source& data)
 			}
 		});
 	impl().loadDocument(data);
+	if (page_workers.v > 1)
+		impl().parseTextConcurrently(page_workers.v);
+	else
 	{
 		std::lock_guard<std::mutex> podofo_mutex_lock(podofo_mutex);
 		impl().parseText();
@@ -22,6 +22,13 @@ namespace docwire
 
 class Metadata;
 
+/**
+	Number of threads decoding pages of a single document.
+	Values greater than one parse pages concurrently, without the process-wide PoDoFo lock,
+	and send them to the chain in page order.
+*/
+struct pdf_page_workers { unsigned int v; };
+
 class DllExport PDFParser : public Parser, public with_pimpl<PDFParser>
 {
 	private:
@@ -32,7 +39,7 @@ class DllExport PDFParser : public Parser, public with_pimpl<PDFParser>
 		attributes::Metadata metaData(const data_source& data);
 
 	public:
-		PDFParser();
+		PDFParser(pdf_page_workers page_workers = pdf_page_workers{1});
 		PDFParser(PDFParser&&) = default;
 		~PDFParser();
 		void parse(const data_source& data) override;
@@ -1,8 +1,7 @@
 add_library(docwire_plain_text SHARED txt_parser.cpp)
 
 find_library(charsetdetect charsetdetect REQUIRED)
-find_library(htmlcxx htmlcxx REQUIRED) # for charset conversion
-target_link_libraries(docwire_plain_text PRIVATE ${charsetdetect} ${htmlcxx} docwire_core)
+target_link_libraries(docwire_plain_text PRIVATE ${charsetdetect} docwire_core)
 find_path(charsetdetect_inc_dir charsetdetect.h REQUIRED)
 target_include_directories(docwire_plain_text PRIVATE ${charsetdetect_inc_dir})
 
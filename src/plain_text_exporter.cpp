@@ -21,17 +21,19 @@ namespace docwire
 template<>
 struct pimpl_impl<PlainTextExporter> : pimpl_impl_base
 {
-	pimpl_impl(eol_sequence eol_sequence, link_formatter link_formatter)
-		: m_writer{eol_sequence.v, link_formatter.format_opening, link_formatter.format_closing}
+	pimpl_impl(eol_sequence eol_sequence, link_formatter link_formatter, flush_threshold flush_threshold)
+		: m_writer{eol_sequence.v, link_formatter.format_opening, link_formatter.format_closing},
+			m_flush_threshold{flush_threshold}
 	{}
 
 	std::shared_ptr<std::stringstream> m_stream;
 	PlainTextWriter m_writer;
 	int m_nested_docs_level { 0 };
+	flush_threshold m_flush_threshold;
 };
 
-PlainTextExporter::PlainTextExporter(eol_sequence eol_sequence, link_formatter link_formatter)
-	: with_pimpl<PlainTextExporter>(eol_sequence, link_formatter)
+PlainTextExporter::PlainTextExporter(eol_sequence eol_sequence, link_formatter link_formatter, flush_threshold flush_threshold)
+	: with_pimpl<PlainTextExporter>(eol_sequence, link_formatter, flush_threshold)
 {}
 
 void PlainTextExporter::process(Info& info)
@@ -58,6 +60,13 @@ void PlainTextExporter::process(Info& info)
 			impl().m_stream.reset();
 		}
 	}
+	else if (impl().m_flush_threshold.v && static_cast<size_t>(impl().m_stream->tellp()) >= *impl().m_flush_threshold.v)
+	{
+		Info chunk_info{data_source{seekable_stream_ptr{impl().m_stream}, file_extension{".txt"}}};
+		emit(chunk_info);
+		info.cancel = chunk_info.cancel;
+		impl().m_stream = std::make_shared<std::stringstream>();
+	}
 }
 
 } // namespace docwire
@@ -13,6 +13,7 @@
 #define DOCWIRE_PLAIN_TEXT_EXPORTER_H
 
 #include "chain_element.h"
+#include "flush_threshold.h"
 
 namespace docwire
 {
@@ -27,11 +28,13 @@ struct link_formatter
 
 /**
  * @brief Exports data to plain text format.
+ *
+ * @see flush_threshold
  */
 class DllExport PlainTextExporter: public ChainElement, public with_pimpl<PlainTextExporter>
 {
 public:
-	PlainTextExporter(eol_sequence eol = eol_sequence{"\n"}, link_formatter formatter = default_link_formatter);
+	PlainTextExporter(eol_sequence eol = eol_sequence{"\n"}, link_formatter formatter = default_link_formatter, flush_threshold flush_threshold = {});
 
   void process(Info& info) override;
 
@@ -40,7 +43,6 @@ public:
 		return false;
 	}
 
-private:
 	inline static const link_formatter default_link_formatter =
 	{
 		.format_opening = [](const tag::Link& link)
@@ -53,6 +55,7 @@ private:
 		}
 	};
 
+private:
 	using with_pimpl<PlainTextExporter>::impl;
 };
 
@@ -13,7 +13,9 @@
 #include <iomanip>
 #include <ctime>
 #include <cassert>
+#include <optional>
 #include <sstream>
+#include <string_view>
 
 #include "plain_text_writer.h"
 #include "error_tags.h"
@@ -22,288 +24,221 @@
 
 namespace docwire
 {
+/**
+ * Text of a single table cell split into lines. Line boundaries are found incrementally as fragments arrive,
+ * so writing to the cell costs time proportional to the fragment size, not to the whole cell text.
+ */
 class Cell
 {
 public:
-  Cell(std::string eol_sequence,
-    std::function<std::string(const tag::Link&)> format_link_opening,
-    std::function<std::string(const tag::CloseLink&)> format_link_closing)
-  : writer(eol_sequence, format_link_opening, format_link_closing)
+  Cell(const std::string& eol_sequence,
+    const std::function<std::string(const tag::Link&)>& format_link_opening,
+    const std::function<std::string(const tag::CloseLink&)>& format_link_closing)
+  : m_eol_sequence(eol_sequence),
+    m_format_link_opening(format_link_opening),
+    m_format_link_closing(format_link_closing)
   {}
 
-  void write(const std::string& s)
+  void write(std::string_view s)
   {
-    result += s;
-    std::stringstream ss(result);
-    lines.clear();
-    const std::string eol_sequence = writer.eol_sequence();
-    std::string::size_type prev_pos = 0;
-    std::string::size_type pos = 0;
-    while ((pos = result.find(eol_sequence, prev_pos)) != std::string::npos)
+    m_text += s;
+    size_t pos = m_scan_pos;
+    while ((pos = m_text.find(m_eol_sequence, pos)) != std::string::npos)
     {
-      lines.push_back(result.substr(prev_pos, pos - prev_pos));
-      prev_pos = pos + eol_sequence.length();
+      m_lines.push_back({m_line_start, pos - m_line_start});
+      m_full_lines_width = std::max(m_full_lines_width, pos - m_line_start);
+      pos += m_eol_sequence.length();
+      m_line_start = pos;
     }
-    if (prev_pos < result.length())
-      lines.push_back(result.substr(prev_pos));
+    // end of the text can be the beginning of end of line sequence split between fragments
+    size_t partial_eol_length = std::min(m_eol_sequence.length() - 1, m_text.length());
+    m_scan_pos = std::max(m_line_start, m_text.length() - partial_eol_length);
   }
 
-  void write(const Tag& tag)
+  /**
+   * Plain text writer is created only for the first tag other than text,
+   * because text tags are written as they are by a writer in its initial state.
+   */
+  void write(const Tag& tag, std::ostringstream& fragment_buffer)
   {
-    std::stringstream stream;
-    writer.write_to(tag, stream);
-    write(stream.str());
-    stream.str(std::string());
-  }
-
-  int width() const
-  {
-    int width = 0;
-    for (const auto & single_line : lines)
+    if (!m_writer)
     {
-      width = std::max(width, int(single_line.size()));
+      if (const tag::Text* text = std::get_if<tag::Text>(&tag))
+      {
+        write(text->text);
+        return;
+      }
+      m_writer.emplace(m_eol_sequence, m_format_link_opening, m_format_link_closing);
     }
-    return width;
+    fragment_buffer.str(std::string{});
+    m_writer->write_to(tag, fragment_buffer);
+    write(fragment_buffer.view());
   }
 
-  int height() const
+  size_t width() const
   {
-    return lines.size();
+    return std::max(m_full_lines_width, has_last_line() ? m_text.length() - m_line_start : 0);
   }
 
-  std::string getLine(unsigned int idx) const
+  size_t height() const
   {
-    return idx < lines.size() ? lines[idx] : "";
+    return m_lines.size() + (has_last_line() ? 1 : 0);
   }
 
-  std::string result_text() const
+  std::string_view getLine(size_t idx) const
   {
-    return result;
+    if (idx < m_lines.size())
+      return std::string_view{m_text}.substr(m_lines[idx].first, m_lines[idx].second);
+    if (idx == m_lines.size() && has_last_line())
+      return std::string_view{m_text}.substr(m_line_start);
+    return {};
   }
 
-  PlainTextWriter writer;
-  std::string result;
-  std::vector<std::string> lines;
+private:
+  const std::string& m_eol_sequence;
+  const std::function<std::string(const tag::Link&)>& m_format_link_opening;
+  const std::function<std::string(const tag::CloseLink&)>& m_format_link_closing;
+  std::optional<PlainTextWriter> m_writer;
+  std::string m_text;
+  std::vector<std::pair<size_t, size_t>> m_lines; // offset and length of lines terminated by end of line sequence
+  size_t m_full_lines_width = 0;
+  size_t m_line_start = 0;
+  size_t m_scan_pos = 0;
+
+  bool has_last_line() const
+  {
+    return m_line_start < m_text.length();
+  }
 };
 
 template<>
 struct pimpl_impl<PlainTextWriter> : pimpl_impl_base
 {
-  std::string timestampToString(unsigned int timestamp)
+  void write_timestamp(unsigned int timestamp, std::ostream& out)
   {
     std::time_t temp = timestamp;
     struct tm time_buffer;
     std::tm* t = thread_safe_gmtime(&temp, time_buffer);
-    std::stringstream stream;
-    stream << std::put_time(t, "%Y-%m-%d %I:%M:%S %p");
-    return stream.str();
+    out << std::put_time(t, "%Y-%m-%d %I:%M:%S %p");
   }
-  std::string add_tabs(const std::string &in_text, int tab_number)
+
+  void write_tabs(int tab_number, std::ostream& out)
   {
-    std::string new_text = in_text;
     for (int i = 0; i < tab_number; i++)
-    {
-      new_text += "\t";
-    }
-    return new_text;
+      out << '\t';
   }
 
-  std::shared_ptr<TextElement>
-  write_mail(const tag::Mail& mail)
+  void write_mail(const tag::Mail& mail, std::ostream& out)
   {
-    std::string text = "";
     if (mail.level)
-    {
-      text = add_tabs(text, *mail.level);
-    }
-    text += "mail: ";
+      write_tabs(*mail.level, out);
+    out << "mail: ";
     if (mail.subject)
-    {
-      text += *mail.subject;
-    }
+      out << *mail.subject;
     if (mail.date)
     {
-      text += " creation time: " + timestampToString(*mail.date) + m_eol_sequence;
+      out << " creation time: ";
+      write_timestamp(*mail.date, out);
+      out << m_eol_sequence;
     }
-    return std::make_shared<TextElement>(text);
   }
 
-  std::shared_ptr<TextElement>
-  write_attachment(const tag::Attachment& attachment)
+  void write_attachment(const tag::Attachment& attachment, std::ostream& out)
   {
-    std::string text = "attachment: " + m_eol_sequence + m_eol_sequence;
+    out << "attachment: " << m_eol_sequence << m_eol_sequence;
     if (attachment.name)
-    {
-      text += "name: " + *attachment.name + m_eol_sequence;
-    }
-    return std::make_shared<TextElement>(text);
+      out << "name: " << *attachment.name << m_eol_sequence;
   }
 
-  std::shared_ptr<TextElement>
-  write_folder(const tag::Folder& folder)
+  void write_folder(const tag::Folder& folder, std::ostream& out)
   {
-    std::string text = "";
     if (folder.level)
-    {
-      text = add_tabs(text, *folder.level);
-    }
-    text += "folder: ";
+      write_tabs(*folder.level, out);
+    out << "folder: ";
     if (folder.name)
-    {
-      text += *folder.name + m_eol_sequence;
-    }
-    return std::make_shared<TextElement>(text);
-  }
-
-  std::shared_ptr<TextElement>
-  write_text(const tag::Text& text)
-  {
-    return std::make_shared<TextElement>(text.text);
-  }
-
-  std::shared_ptr<TextElement>
-  write_close_mail_body(const tag::CloseMailBody&)
-  {
-    return std::make_shared<TextElement>(m_eol_sequence);
-  }
-
-  std::shared_ptr<TextElement>
-  write_close_attachment(const tag::CloseAttachment&)
-  {
-    return std::make_shared<TextElement>(m_eol_sequence);
-  }
-
-  std::shared_ptr<TextElement>
-  write_new_line(const tag::BreakLine&)
-  {
-    return std::make_shared<TextElement>(m_eol_sequence);
+      out << *folder.name << m_eol_sequence;
   }
 
-  std::shared_ptr<TextElement>
-  write_new_paragraph(const tag::CloseParagraph&)
+  void write_new_paragraph(std::ostream& out)
   {
-    if (list_mode)
-    {
-      return std::make_shared<TextElement>("");
-    }
-    return std::make_shared<TextElement>(m_eol_sequence);
+    if (!list_mode)
+      out << m_eol_sequence;
   }
 
-  std::shared_ptr<TextElement>
-  write_image(const tag::Image& image)
+  void write_image(const tag::Image& image, std::ostream& out)
   {
     if (image.alt)
-    {
-      return std::make_shared<TextElement>(*image.alt);
-    }
-    return std::make_shared<TextElement>("");
+      out << *image.alt;
   }
 
-  std::shared_ptr<TextElement>
-  turn_on_table_mode(const tag::Table&)
-  {
-    return std::make_shared<TextElement>("");
-  }
-
-  std::shared_ptr<TextElement>
-  turn_off_table_mode(const tag::CloseTable&)
-  {
-    return std::make_shared<TextElement>("");
-  }
-
-  std::shared_ptr<TextElement>
-  write_list(const tag::List& list)
+  void write_list(const tag::List& list, std::ostream& out)
   {
     list_mode = true;
     list_counter = 1;
     list_type = list.type;
-    return std::make_shared<TextElement>(m_eol_sequence);
+    out << m_eol_sequence;
   }
 
-  std::shared_ptr<TextElement>
-  write_close_list(const tag::CloseList&)
+  void write_close_list()
   {
     list_mode = false;
     list_counter = 1;
-    return std::make_shared<TextElement>("");
   }
 
-  std::shared_ptr<TextElement>
-  write_list_item(const tag::ListItem&)
+  void write_list_item(std::ostream& out)
   {
     if (list_type == "none")
-      return std::make_shared<TextElement>("");
+      return;
     else if (list_type == "decimal")
-      return std::make_shared<TextElement>(std::to_string(list_counter) + ". ");
+      out << list_counter << ". ";
     else if (list_type == "disc")
-      return std::make_shared<TextElement>("* ");
+      out << "* ";
     else
-      return std::make_shared<TextElement>(list_type);
+      out << list_type;
   }
 
-  std::shared_ptr<TextElement>
-  write_close_list_item(const tag::CloseListItem&)
+  void write_close_list_item(std::ostream& out)
   {
     ++list_counter;
-    return std::make_shared<TextElement>(m_eol_sequence);
+    out << m_eol_sequence;
   }
 
-	std::shared_ptr<TextElement>
-	write_comment(const tag::Comment& comment)
+	void write_comment(const tag::Comment& comment, std::ostream& out)
 	{
-		std::string text = m_eol_sequence + "[[[";
+		out << m_eol_sequence << "[[[";
 		if (comment.author)
-		{
-			text += "COMMENT BY " + *comment.author;
-		}
+			out << "COMMENT BY " << *comment.author;
 		if (comment.time)
-		{
-			text += " (" + *comment.time + ")";
-		}
-		text += "]]]" + m_eol_sequence;
+			out << " (" << *comment.time << ")";
+		out << "]]]" << m_eol_sequence;
 		if (comment.comment)
 		{
-			auto comment_text = *comment.comment;
-			text += comment_text;
-			if (comment_text.empty() || *comment_text.rbegin() != '\n')
-				text += m_eol_sequence;
+			const std::string& comment_text = *comment.comment;
+			out << comment_text;
+			if (comment_text.empty() || comment_text.back() != '\n')
+				out << m_eol_sequence;
 		}
-		text += "[[[---]]]" + m_eol_sequence;
-
-		return std::make_shared<TextElement>(text);
+		out << "[[[---]]]" << m_eol_sequence;
 	}
 
-	std::shared_ptr<TextElement> write_header(const tag::Header&)
-	{
-		header_mode = true;
-		return std::make_shared<TextElement>("");
-	}
-
-	std::shared_ptr<TextElement> write_close_header(const tag::CloseHeader&)
+	void write_close_header(std::ostream& out)
 	{
 		header_mode = false;
-		return std::make_shared<TextElement>(m_eol_sequence);
+		out << m_eol_sequence;
 	}
 
-	std::shared_ptr<TextElement> write_footer(const tag::Footer&)
+	void write_footer()
 	{
 		footer_mode = true;
 		footer_stream.str("");
-		return std::make_shared<TextElement>("");
-	}
-
-	std::shared_ptr<TextElement> write_close_footer(const tag::CloseFooter&)
-	{
-		footer_mode = false;
-		return std::make_shared<TextElement>("");
 	}
 
-	std::shared_ptr<TextElement> write_close_document(const tag::CloseDocument&)
+	void write_close_document(std::ostream& out)
 	{
 		std::string footer = footer_stream.str();
+		out << m_eol_sequence << footer;
 		if (!footer.empty())
-			footer += m_eol_sequence;
-		return std::make_shared<TextElement>(m_eol_sequence + footer);
+			out << m_eol_sequence;
 	}
 
   pimpl_impl(const std::string& eol_sequence,
@@ -315,62 +250,43 @@ struct pimpl_impl<PlainTextWriter> : pimpl_impl_base
   {
   }
 
-  std::string add_shift(int count)
-  {
-    std::string shift;
-    for (int i = 0; i < count; ++i)
-    {
-      shift += " ";
-    }
-    return shift;
-  }
-
-  std::string render_table()
+  void render_table(std::ostream& stream)
   {
-    std::string result;
-    int max_column_width = 0;
-    int cell_in_row = 0;
-
+    size_t max_column_width = 0;
     for (const auto &row : table)
-    {
-      cell_in_row = std::max(cell_in_row, int(row.size()));
       for (const auto &cell : row)
-      {
         max_column_width = std::max(max_column_width, cell.width());
-      }
-    }
 
+    std::string line;
     for (const auto &row : table)
     {
-      std::string row_result;
-      unsigned int max_row_height = 1; // empty rows or rows with all cells empty should be visible
+      size_t max_row_height = 1; // empty rows or rows with all cells empty should be visible
       for (const auto &cell : row)
+        max_row_height = std::max(max_row_height, cell.height());
+      for (size_t i = 0; i < max_row_height; ++i)
       {
-        max_row_height = std::max(int(max_row_height), cell.height());
-      }
-      for (unsigned int i = 0; i < max_row_height; ++i)
-      {
-        for (unsigned int j = 0; j < row.size(); ++j)
+        line.clear();
+        for (size_t j = 0; j < row.size(); ++j)
         {
-          row_result += row[j].getLine(i);
-          int size_diff = max_column_width - row[j].getLine(i).size();
-          int right_margin = j < (row.size() - 1) ? 2 : 0;
-          row_result += add_shift(size_diff + right_margin);
+          std::string_view cell_line = row[j].getLine(i);
+          line += cell_line;
+          size_t right_margin = j < (row.size() - 1) ? 2 : 0;
+          line.append(max_column_width - cell_line.size() + right_margin, ' ');
         }
-        row_result += m_eol_sequence;
+        line += m_eol_sequence;
+        stream << line;
       }
-      result += row_result;
     }
-    return result;
   }
 
-  std::string create_table()
+  void create_table(std::ostream& stream)
   {
+    std::ostringstream fragment_buffer;
     for (unsigned int i = 0; i < tags.size(); ++i)
     {
       if (std::holds_alternative<tag::Table>(tags[i]))
       {
-        std::stringstream ss;
+        std::ostringstream ss;
         PlainTextWriter writer{m_eol_sequence, m_format_link_opening, m_format_link_closing};
         int open_table_tags = 1;
         writer.write_to(tags[i], ss);
@@ -385,7 +301,7 @@ struct pimpl_impl<PlainTextWriter> : pimpl_impl_base
         while (open_table_tags > 0);
         throw_if (table.empty(), "Table inside table without rows", errors::program_logic{});
         throw_if (table.back().empty(), "Table inside table row without cells", errors::program_logic{});
-        table.back().back().write(ss.str());
+        table.back().back().write(ss.view());
       }
 
       else if (std::holds_alternative<tag::TableRow>(tags[i]))
@@ -395,16 +311,16 @@ struct pimpl_impl<PlainTextWriter> : pimpl_impl_base
       else if (std::holds_alternative<tag::TableCell>(tags[i]))
       {
         throw_if (table.empty(), "Cell inside table without rows", errors::program_logic{});
-        table.back().push_back(Cell{m_eol_sequence, m_format_link_opening, m_format_link_closing});
+        table.back().emplace_back(m_eol_sequence, m_format_link_opening, m_format_link_closing);
       }
       else if (!std::holds_alternative<tag::CloseTableRow>(tags[i]) && !std::holds_alternative<tag::CloseTableCell>(tags[i]))
       {
         throw_if (table.empty(), "Cell content inside table without rows", errors::program_logic{});
         throw_if (table.back().empty(), "Cell content inside table row without cells", errors::program_logic{});
-        table.back().back().write(tags[i]);
+        table.back().back().write(tags[i], fragment_buffer);
       }
     }
-    return render_table();
+    render_table(stream);
   }
 
   void write_to(const Tag& tag, std::ostream &stream)
@@ -415,7 +331,7 @@ struct pimpl_impl<PlainTextWriter> : pimpl_impl_base
 
       if (level == 0)
       {
-        stream << create_table();
+        create_table(stream);
         tags.clear();
         table.clear();
         return;
@@ -434,40 +350,37 @@ struct pimpl_impl<PlainTextWriter> : pimpl_impl_base
 
     if (level == 0)
     {
-      auto text_element = std::visit(
+      std::ostream& out = footer_mode ? footer_stream : stream;
+      std::visit(
         overloaded
         {
-          [this](const tag::Mail& tag){return write_mail(tag);},
-          [this](const tag::Attachment& tag){return write_attachment(tag);},
-          [this](const tag::Folder& tag){return write_folder(tag);},
-          [this](const tag::Text& tag){return write_text(tag);},
-          [this](const tag::CloseMailBody& tag){return write_close_mail_body(tag);},
-          [this](const tag::CloseAttachment& tag){return write_close_attachment(tag);},
-          [this](const tag::BreakLine& tag){return write_new_line(tag);},
-          [this](const tag::CloseParagraph& tag){return write_new_paragraph(tag);},
-          [this](const tag::CloseSection& tag){return write_new_paragraph(tag::CloseParagraph());},
-          [this](const tag::Table& tag){return turn_on_table_mode(tag);},
-          [this](const tag::CloseTable& tag){return turn_off_table_mode(tag);},
-          [this](const tag::Link& tag){return std::make_shared<TextElement>(m_format_link_opening(tag));},
-          [this](const tag::CloseLink& tag){return std::make_shared<TextElement>(m_format_link_closing(tag));},
-          [this](const tag::Image& tag){return write_image(tag);},
-          [this](const tag::List& tag){return write_list(tag);},
-          [this](const tag::CloseList& tag){return write_close_list(tag);},
-          [this](const tag::ListItem& tag){return write_list_item(tag);},
-          [this](const tag::CloseListItem& tag){return write_close_list_item(tag);},
-          [this](const tag::Header& tag){return write_header(tag);},
-          [this](const tag::CloseHeader& tag){return write_close_header(tag);},
-          [this](const tag::Footer& tag){return write_footer(tag);},
-          [this](const tag::CloseFooter& tag){return write_close_footer(tag);},
-          [this](const tag::Comment& tag){return write_comment(tag);},
-          [this](const tag::Document& tag) { m_nested_docs_counter++; return std::shared_ptr<TextElement>(); },
-          [this](const tag::CloseDocument& tag) { m_nested_docs_counter--; return m_nested_docs_counter == 0 ? write_close_document(tag) : std::shared_ptr<TextElement>(); },
-          [](const auto&) {return std::shared_ptr<TextElement>{};}
+          [this, &out](const tag::Mail& tag){ write_mail(tag, out); },
+          [this, &out](const tag::Attachment& tag){ write_attachment(tag, out); },
+          [this, &out](const tag::Folder& tag){ write_folder(tag, out); },
+          [&out](const tag::Text& tag){ out << tag.text; },
+          [this, &out](const tag::CloseMailBody&){ out << m_eol_sequence; },
+          [this, &out](const tag::CloseAttachment&){ out << m_eol_sequence; },
+          [this, &out](const tag::BreakLine&){ out << m_eol_sequence; },
+          [this, &out](const tag::CloseParagraph&){ write_new_paragraph(out); },
+          [this, &out](const tag::CloseSection&){ write_new_paragraph(out); },
+          [this, &out](const tag::Link& tag){ out << m_format_link_opening(tag); },
+          [this, &out](const tag::CloseLink& tag){ out << m_format_link_closing(tag); },
+          [this, &out](const tag::Image& tag){ write_image(tag, out); },
+          [this, &out](const tag::List& tag){ write_list(tag, out); },
+          [this](const tag::CloseList&){ write_close_list(); },
+          [this, &out](const tag::ListItem&){ write_list_item(out); },
+          [this, &out](const tag::CloseListItem&){ write_close_list_item(out); },
+          [this](const tag::Header&){ header_mode = true; },
+          [this, &out](const tag::CloseHeader&){ write_close_header(out); },
+          [this](const tag::Footer&){ write_footer(); },
+          [this](const tag::CloseFooter&){ footer_mode = false; },
+          [this, &out](const tag::Comment& tag){ write_comment(tag, out); },
+          [this](const tag::Document&) { m_nested_docs_counter++; },
+          [this, &out](const tag::CloseDocument&) { if (--m_nested_docs_counter == 0) write_close_document(out); },
+          [](const auto&) {}
         },
 	      tag
       );
-      if (text_element)
-        text_element->write_to(footer_mode ? footer_stream : stream);
     }
   }
 
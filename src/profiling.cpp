@@ -0,0 +1,214 @@
+/*********************************************************************************************************************************************/
+/*  DocWire SDK: Award-winning modern data processing in C++20. SourceForge Community Choice & Microsoft support. AI-driven processing.      */
+/*  Supports nearly 100 data formats, including email boxes and OCR. Boost efficiency in text extraction, web data extraction, data mining,  */
+/*  document analysis. Offline processing possible for security and confidentiality                                                          */
+/*                                                                                                                                           */
+/*  Copyright (c) SILVERCODERS Ltd, http://silvercoders.com                                                                                  */
+/*  Project homepage: https://github.com/docwire/docwire                                                                                     */
+/*                                                                                                                                           */
+/*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
+/*********************************************************************************************************************************************/
+
+
+#include "profiling.h"
+
+#include "parsing_chain.h"
+#include <algorithm>
+#include <atomic>
+#include <boost/core/demangle.hpp>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <typeindex>
+
+namespace docwire
+{
+namespace profiling
+{
+
+namespace
+{
+
+using key = std::pair<std::type_index, std::type_index>;
+
+struct counters
+{
+	std::uint64_t calls = 0;
+	std::chrono::nanoseconds inclusive_time { 0 };
+	std::chrono::nanoseconds exclusive_time { 0 };
+	std::uint64_t text_bytes = 0;
+
+	counters& operator+=(const counters& other)
+	{
+		calls += other.calls;
+		inclusive_time += other.inclusive_time;
+		exclusive_time += other.exclusive_time;
+		text_bytes += other.text_bytes;
+		return *this;
+	}
+};
+
+using counters_map = std::map<key, counters>;
+
+std::atomic<bool> enabled { false };
+std::atomic<std::uint64_t> generation { 0 };
+
+struct global_data
+{
+	std::mutex mutex;
+	counters_map counters;
+};
+
+global_data& global()
+{
+	static global_data data;
+	return data;
+}
+
+void merge(counters_map& target, const counters_map& source)
+{
+	for (const auto& [k, c] : source)
+		target[k] += c;
+}
+
+struct thread_data
+{
+	counters_map counters;
+	std::uint64_t generation = 0;
+	scope* current_scope = nullptr;
+
+	thread_data()
+	{
+		global(); // make sure global data outlives thread data of main thread
+	}
+
+	~thread_data()
+	{
+		global_data& g = global();
+		std::lock_guard<std::mutex> lock(g.mutex);
+		if (generation == profiling::generation.load())
+			merge(g.counters, counters);
+	}
+
+	counters_map& current_counters()
+	{
+		std::uint64_t current_generation = profiling::generation.load(std::memory_order_relaxed);
+		if (generation != current_generation)
+		{
+			counters.clear();
+			generation = current_generation;
+		}
+		return counters;
+	}
+};
+
+thread_data& this_thread_data()
+{
+	thread_local thread_data data;
+	return data;
+}
+
+std::string type_name(std::type_index type)
+{
+	std::string name = boost::core::demangle(type.name());
+	for (std::string_view prefix : { "docwire::tag::", "docwire::" })
+	{
+		if (name.starts_with(prefix))
+			return name.substr(prefix.size());
+	}
+	return name;
+}
+
+} // anonymous namespace
+
+void enable(bool enabled)
+{
+	profiling::enabled.store(enabled);
+}
+
+bool is_enabled()
+{
+	return enabled.load(std::memory_order_relaxed);
+}
+
+void reset()
+{
+	global_data& g = global();
+	std::lock_guard<std::mutex> lock(g.mutex);
+	g.counters.clear();
+	generation++;
+}
+
+std::vector<entry> report()
+{
+	counters_map all_counters;
+	{
+		global_data& g = global();
+		std::lock_guard<std::mutex> lock(g.mutex);
+		all_counters = g.counters;
+	}
+	merge(all_counters, this_thread_data().current_counters());
+	std::vector<entry> entries;
+	entries.reserve(all_counters.size());
+	for (const auto& [k, c] : all_counters)
+		entries.push_back(entry{type_name(k.first), type_name(k.second), c.calls, c.inclusive_time, c.exclusive_time, c.text_bytes});
+	std::sort(entries.begin(), entries.end(), [](const entry& e1, const entry& e2)
+	{
+		return e1.exclusive_time > e2.exclusive_time;
+	});
+	return entries;
+}
+
+void write_report(std::ostream& stream)
+{
+	auto milliseconds = [](std::chrono::nanoseconds time)
+	{
+		return std::chrono::duration<double, std::milli>(time).count();
+	};
+	stream << std::left << std::setw(40) << "element" << std::setw(20) << "tag" << std::right <<
+		std::setw(12) << "calls" << std::setw(16) << "inclusive [ms]" << std::setw(16) << "exclusive [ms]" <<
+		std::setw(14) << "text bytes" << std::endl;
+	std::ios_base::fmtflags flags = stream.flags();
+	stream << std::fixed << std::setprecision(3);
+	for (const entry& e : report())
+	{
+		stream << std::left << std::setw(40) << e.element << std::setw(20) << e.tag << std::right <<
+			std::setw(12) << e.calls << std::setw(16) << milliseconds(e.inclusive_time) <<
+			std::setw(16) << milliseconds(e.exclusive_time) << std::setw(14) << e.text_bytes << std::endl;
+	}
+	stream.flags(flags);
+}
+
+scope::scope(const std::type_info& element_type, const Tag& tag)
+	: m_active{is_enabled() && element_type != typeid(ParsingChain)}
+{
+	if (!m_active)
+		return;
+	m_element_type = &element_type;
+	m_tag_type = &std::visit([](const auto& t) -> const std::type_info& { return typeid(t); }, tag);
+	m_text_bytes = std::holds_alternative<tag::Text>(tag) ? std::get<tag::Text>(tag).text.size() : 0;
+	m_children_time = std::chrono::nanoseconds{0};
+	thread_data& data = this_thread_data();
+	m_parent = data.current_scope;
+	data.current_scope = this;
+	m_start_time = std::chrono::steady_clock::now();
+}
+
+scope::~scope()
+{
+	if (!m_active)
+		return;
+	std::chrono::nanoseconds inclusive_time = std::chrono::steady_clock::now() - m_start_time;
+	thread_data& data = this_thread_data();
+	data.current_scope = m_parent;
+	if (m_parent)
+		m_parent->m_children_time += inclusive_time;
+	counters& c = data.current_counters()[key{*m_element_type, *m_tag_type}];
+	c.calls++;
+	c.inclusive_time += inclusive_time;
+	c.exclusive_time += inclusive_time - m_children_time;
+	c.text_bytes += m_text_bytes;
+}
+
+} // namespace profiling
+} // namespace docwire
@@ -0,0 +1,95 @@
+/*********************************************************************************************************************************************/
+/*  DocWire SDK: Award-winning modern data processing in C++20. SourceForge Community Choice & Microsoft support. AI-driven processing.      */
+/*  Supports nearly 100 data formats, including email boxes and OCR. Boost efficiency in text extraction, web data extraction, data mining,  */
+/*  document analysis. Offline processing possible for security and confidentiality                                                          */
+/*                                                                                                                                           */
+/*  Copyright (c) SILVERCODERS Ltd, http://silvercoders.com                                                                                  */
+/*  Project homepage: https://github.com/docwire/docwire                                                                                     */
+/*                                                                                                                                           */
+/*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
+/*********************************************************************************************************************************************/
+
+
+#ifndef DOCWIRE_PROFILING_H
+#define DOCWIRE_PROFILING_H
+
+#include "defines.h"
+#include "tags.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace docwire
+{
+
+/**
+ * @brief Opt-in instrumentation of chain elements.
+ *
+ * When enabled, every call of a chain element is recorded per element type and per type of the incoming tag:
+ * number of calls, inclusive time (including time spent in following elements of the chain),
+ * exclusive time (time spent in the element itself) and number of bytes of text tags.
+ * Parsing chains themselves are not recorded, only the elements they connect.
+ *
+ * Every thread collects measurements separately. Measurements of other threads are included in the report
+ * after these threads are finished.
+ */
+namespace profiling
+{
+
+struct DllExport entry
+{
+	std::string element;
+	std::string tag;
+	std::uint64_t calls = 0;
+	std::chrono::nanoseconds inclusive_time { 0 };
+	std::chrono::nanoseconds exclusive_time { 0 };
+	std::uint64_t text_bytes = 0;
+};
+
+DllExport void enable(bool enabled = true);
+
+DllExport bool is_enabled();
+
+/**
+ * @brief Discard all measurements collected so far.
+ */
+DllExport void reset();
+
+/**
+ * @brief Measurements collected so far, sorted by exclusive time (descending).
+ */
+DllExport std::vector<entry> report();
+
+/**
+ * @brief Write measurements collected so far as a human readable table.
+ */
+DllExport void write_report(std::ostream& stream);
+
+/**
+ * @brief Measures single call of a chain element. Does nothing if profiling is not enabled.
+ */
+class DllExport scope
+{
+public:
+	scope(const std::type_info& element_type, const Tag& tag);
+	~scope();
+	scope(const scope&) = delete;
+	scope& operator=(const scope&) = delete;
+
+private:
+	bool m_active;
+	const std::type_info* m_element_type;
+	const std::type_info* m_tag_type;
+	std::uint64_t m_text_bytes;
+	std::chrono::steady_clock::time_point m_start_time;
+	std::chrono::nanoseconds m_children_time;
+	scope* m_parent;
+};
+
+} // namespace profiling
+} // namespace docwire
+
+#endif //DOCWIRE_PROFILING_H
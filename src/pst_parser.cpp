@@ -10,11 +10,17 @@
 /*********************************************************************************************************************************************/
 
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <iomanip>
 #include <ctime>
+#include <mutex>
 
 #include <optional>
 #include <iostream>
+#include <thread>
 extern "C"
 {
 #define LIBPFF_HAVE_BFIO
@@ -26,8 +32,10 @@ extern "C"
 #include "error_tags.h"
 #include "log.h"
 #include "misc.h"
+#include "parsing_chain.h"
 #include "pst_parser.h"
 #include "throw_if.h"
+#include "transformer_func.h"
 
 namespace docwire
 {
@@ -144,16 +152,91 @@ struct pffItem
 	}
 };
 
-struct RawAttachment
+namespace
+{
+class pffFile;
+} // anonymous namespace
+
+/**
+	Reads attachment data on demand straight from the PST file, so attachment content is loaded
+	only if and when downstream element consumes it. Keeps the PST file open, so the stream stays readable
+	after the parser returns. PST files that are not read from a path are read from memory of their data source.
+*/
+class AttachmentStreamBuf : public std::streambuf
+{
+public:
+	AttachmentStreamBuf(std::shared_ptr<const pffFile> file, pffItem item, size_t size)
+		: m_file(std::move(file)), m_item(std::move(item)), m_size(size)
+	{
+	}
+
+	int_type underflow() override
+	{
+		if (m_position >= m_size)
+			return traits_type::eof();
+		pffError err;
+		ssize_t bytes_read = libpff_attachment_data_read_buffer(m_item, (uint8_t*)m_buffer,
+			std::min(m_buf_size, m_size - m_position), &err);
+		throw_if (bytes_read < 0, "libpff_attachment_data_read_buffer() failed", errors::uninterpretable_data{});
+		if (bytes_read == 0)
+			return traits_type::eof();
+		m_position += bytes_read;
+		setg(m_buffer, m_buffer, m_buffer + bytes_read);
+		return traits_type::to_int_type(*gptr());
+	}
+
+	pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+	{
+		if (!(which & std::ios_base::in))
+			return pos_type(off_type(-1));
+		off_type current = static_cast<off_type>(m_position) - (egptr() - gptr());
+		off_type target = dir == std::ios_base::beg ? off : (dir == std::ios_base::cur ? current + off : static_cast<off_type>(m_size) + off);
+		if (target < 0 || target > static_cast<off_type>(m_size))
+			return pos_type(off_type(-1));
+		if (target == current)
+			return pos_type(target);
+		pffError err;
+		if (libpff_attachment_data_seek_offset(m_item, target, SEEK_SET, &err) == -1)
+			return pos_type(off_type(-1));
+		m_position = static_cast<size_t>(target);
+		setg(m_buffer, m_buffer, m_buffer);
+		return pos_type(target);
+	}
+
+	pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+	{
+		return seekoff(off_type(pos), std::ios_base::beg, which);
+	}
+
+private:
+	std::shared_ptr<const pffFile> m_file;
+	pffItem m_item;
+	size_t m_size;
+	size_t m_position = 0;
+	static constexpr size_t m_buf_size = 65536;
+	char m_buffer[m_buf_size];
+};
+
+class AttachmentIStream : public std::istream
+{
+public:
+	AttachmentIStream(std::shared_ptr<const pffFile> file, pffItem item, size_t size)
+		: std::istream(new AttachmentStreamBuf(std::move(file), std::move(item), size)) {}
+
+	~AttachmentIStream() { delete rdbuf(); }
+};
+
+struct LazyAttachment
 {
-  RawAttachment(size_t size, std::unique_ptr<uint8_t[]>& raw_data, std::string name)
-  : m_size(size),
-    m_raw_data(std::move(raw_data)),
-    m_name(name)
-  {}
-  std::string m_name;
-  size_t m_size;
-  std::unique_ptr<uint8_t[]> m_raw_data;
+	std::string m_name;
+	size_t m_size;
+	pffItem m_item;
+	std::shared_ptr<const pffFile> m_file;
+
+	std::shared_ptr<std::istream> stream() &&
+	{
+		return std::make_shared<AttachmentIStream>(std::move(m_file), std::move(m_item), m_size);
+	}
 };
 
 class Message
@@ -255,12 +338,12 @@ class Message
     return {};
 	}
 
-	std::vector<RawAttachment>
-	getAttachments()
+	std::vector<LazyAttachment>
+	getAttachments(const std::shared_ptr<const pffFile>& file)
 	{
 		int items;
 		pffError err;
-    std::vector<RawAttachment> attachments;
+    std::vector<LazyAttachment> attachments;
     if (libpff_message_get_number_of_attachments(_messageHandle, &items, &err) != 1)
 		{
 			return {};
@@ -279,14 +362,8 @@ class Message
 				docwire_log(debug) << "Get data size failed";
 				continue;
 			}
-			std::unique_ptr<uint8_t[]> datablob(new uint8_t[size + 1]);
-			if (libpff_attachment_data_read_buffer(item, datablob.get(), size, &err) == -1)
-			{
-				docwire_log(debug) << "Data Read failed";
-				continue;
-			}
       std::string attachment_name = getAttachmentName(item).get();
-      attachments.push_back(RawAttachment(size, datablob, attachment_name));
+      attachments.push_back(LazyAttachment{attachment_name, static_cast<size_t>(size), std::move(item), file});
 		}
 		return attachments;
 	}
@@ -333,6 +410,13 @@ class Folder
 		return msg;
 	}
 
+	uint32_t getIdentifier() const
+	{
+		uint32_t identifier = 0;
+		libpff_item_get_identifier(_folderHandle, &identifier, nullptr);
+		return identifier;
+	}
+
 	std::string getName() const
 	{
 		size_t name_size;
@@ -346,65 +430,6 @@ class Folder
 	pffItem _folderHandle;
 };
 
-template<>
-struct pimpl_impl<PSTParser> : with_pimpl_owner<PSTParser>
-{
-	pimpl_impl(PSTParser& owner) : with_pimpl_owner{owner} {}
-	void parse(std::shared_ptr<std::istream>) const;
-
-  private:
-    void parse_element(const char* buffer, size_t size, const std::string& extension="") const;
-    void parse_internal(const Folder& root, int deep, unsigned int &mail_counter) const;
-};
-
-void pimpl_impl<PSTParser>::parse_internal(const Folder& root, int deep, unsigned int &mail_counter) const
-{
-	for (int i = 0; i < root.getSubFolderNumber(); ++i)
-	{
-		auto sub_folder = root.getSubFolder(i);
-    auto callback = owner().sendTag(tag::Folder{.name = sub_folder.getName(), .level = deep});
-    if(callback.skip)
-    {
-      continue;
-    }
-    parse_internal(sub_folder, deep + 1, mail_counter);
-	owner().sendTag(tag::CloseFolder{});
-	}
-	for (int i = 0; i < root.getMessageNumber(); ++i)
-	{
-		auto message = root.getMessage(i);
-
-    auto html_text = message.getTextAsHtml();
-    if(html_text)
-    {
-      auto callback = owner().sendTag(tag::Mail{.subject = message.getName(), .date = message.getCreationDate(), .level = deep});
-      if(callback.skip)
-      {
-        continue;
-      }
-      owner().sendTag(tag::MailBody{});
-      owner().sendTag(data_source{*html_text, mime_type { "text/html" }, confidence::very_high});
-      ++mail_counter;
-      owner().sendTag(tag::CloseMailBody{});
-    }
-
-		auto attachments = message.getAttachments();
-    for (auto &attachment : attachments)
-    {
-      file_extension extension { std::filesystem::path{attachment.m_name} };
-      auto callback = owner().sendTag(
-        tag::Attachment{.name = attachment.m_name, .size = attachment.m_size, .extension = extension});
-      if(callback.skip)
-      {
-        continue;
-      }
-      owner().sendTag(data_source{std::string((const char*)attachment.m_raw_data.get(), attachment.m_size), extension});
-      owner().sendTag(tag::CloseAttachment{});
-    }
-	owner().sendTag(tag::CloseMail{});
-	}
-}
-
 namespace
 {
 
@@ -462,55 +487,431 @@ void libbfio_stream_initialize(libbfio_handle_t** handle, std::shared_ptr<std::i
 	throw_if (libbfio_handle_initialize_result != 1, "libbfio_handle_initialize failed", libbfio_handle_initialize_result);
 }
 
+/**
+	Creates libbfio file handle, so libpff reads directly from disk
+	instead of the whole file being loaded into memory first.
+*/
+bool libbfio_file_initialize_for_path(libbfio_handle_t** handle, const std::filesystem::path& path)
+{
+	libbfio_error_t* bfio_error = nullptr;
+	std::string name = path.string();
+	if (libbfio_file_initialize(handle, &bfio_error) != 1)
+	{
+		libbfio_error_free(&bfio_error);
+		return false;
+	}
+	if (libbfio_file_set_name(*handle, name.c_str(), name.length(), &bfio_error) != 1)
+	{
+		libbfio_handle_free(handle, nullptr);
+		libbfio_error_free(&bfio_error);
+		return false;
+	}
+	return true;
+}
+
+/**
+	libpff file opened for reading together with the libbfio handle it reads from.
+*/
+class pffFile
+{
+public:
+	explicit pffFile(const data_source& data)
+	{
+		std::optional<std::filesystem::path> path = data.path();
+		if (path && libbfio_file_initialize_for_path(&m_handle, *path))
+			docwire_log(debug) << "Reading PST file directly from disk: " << path->string();
+		else
+		{
+			m_stream = data.istream();
+			libbfio_stream_initialize(&m_handle, m_stream);
+			libbfio_error_t* bfio_error = nullptr;
+			libbfio_handle_open(m_handle, LIBBFIO_OPEN_READ, &bfio_error);
+			libbfio_error_free(&bfio_error);
+		}
+		pffError error{nullptr};
+		if (libpff_file_initialize(&m_file, &error) != 1)
+		{
+			close();
+			throw make_error("libpff_file_initialize failed");
+		}
+		libpff_file_open_file_io_handle(m_file, m_handle, LIBBFIO_OPEN_READ, &error);
+	}
+
+	~pffFile()
+	{
+		close();
+	}
+
+	pffFile(const pffFile&) = delete;
+	pffFile& operator=(const pffFile&) = delete;
+
+	Folder getRootFolder() const
+	{
+		libpff_item_t* root = nullptr;
+		libpff_file_get_root_folder(m_file, &root, nullptr);
+		return Folder(root);
+	}
+
+	Folder getFolder(uint32_t identifier) const
+	{
+		libpff_item_t* folder = nullptr;
+		pffError error{nullptr};
+		throw_if (libpff_file_get_item_by_identifier(m_file, identifier, &folder, &error) != 1,
+			"libpff_file_get_item_by_identifier failed", identifier, errors::uninterpretable_data{});
+		return Folder(folder);
+	}
+
+private:
+	std::shared_ptr<std::istream> m_stream;
+	libbfio_handle_t* m_handle = nullptr;
+	libpff_file_t* m_file = nullptr;
+
+	void close()
+	{
+		pffError error{nullptr};
+		libbfio_error_t* bfio_error = nullptr;
+		if (m_file)
+		{
+			libpff_file_close(m_file, &error);
+			libpff_file_free(&m_file, &error);
+		}
+		if (m_handle)
+		{
+			libbfio_handle_close(m_handle, &bfio_error);
+			libbfio_handle_free(&m_handle, &bfio_error);
+		}
+		libbfio_error_free(&bfio_error);
+	}
+};
+
+/**
+	Attachment of a message read by a message worker.
+*/
+struct AttachmentContent
+{
+	std::string m_name;
+	size_t m_size;
+	std::vector<Tag> m_tags; //!< data source of the attachment or tags it was parsed to
+};
+
+/**
+	Part of the message that is read by worker threads when messages are read concurrently.
+*/
+struct MessageContent
+{
+	std::optional<std::vector<Tag>> m_html_body; //!< data source of HTML body or tags it was parsed to, not set if message has no HTML body
+	std::string m_subject;
+	uint32_t m_creation_date = 0;
+	std::optional<std::vector<AttachmentContent>> m_attachments; //!< not set if attachments are read lazily by the calling thread
+	std::exception_ptr m_failure;
+	bool m_ready = false;
+};
+
+MessageContent readMessageContent(const Message& message)
+{
+	MessageContent content;
+	if (std::optional<std::string> html_body = message.getTextAsHtml())
+	{
+		content.m_html_body.emplace();
+		content.m_html_body->emplace_back(data_source{std::move(*html_body), mime_type { "text/html" }, confidence::very_high});
+		content.m_subject = message.getName();
+		content.m_creation_date = message.getCreationDate();
+	}
+	return content;
+}
+
+/**
+	libpff file of a single message worker together with chain element parsing bodies and attachments
+	of messages it reads, if worker parsers are set.
+*/
+class MessageWorker
+{
+public:
+	MessageWorker(const data_source& data, const pst_worker_parsers& worker_parsers)
+		: m_file{std::make_shared<const pffFile>(data)}
+	{
+		if (worker_parsers.v)
+			m_chain.emplace(worker_parsers.v(), TransformerFunc{[this](Info& info) { m_tags->push_back(info.tag); }});
+	}
+
+	MessageWorker(const MessageWorker&) = delete;
+	MessageWorker& operator=(const MessageWorker&) = delete;
+
+	const pffFile& file() const
+	{
+		return *m_file;
+	}
+
+	MessageContent readMessage(Message message)
+	{
+		MessageContent content = readMessageContent(message);
+		if (!m_chain)
+			return content;
+		if (content.m_html_body)
+			content.m_html_body = parse(std::move(content.m_html_body->front()));
+		content.m_attachments.emplace();
+		for (LazyAttachment& attachment : message.getAttachments(m_file))
+		{
+			std::string name = attachment.m_name;
+			size_t size = attachment.m_size;
+			// Attachment is read into memory, because libpff file of the worker is not read by other threads.
+			std::vector<std::byte> attachment_data(size);
+			std::shared_ptr<std::istream> stream = std::move(attachment).stream();
+			stream->read(reinterpret_cast<char*>(attachment_data.data()), attachment_data.size());
+			attachment_data.resize(stream->gcount());
+			content.m_attachments->push_back(AttachmentContent{name, size,
+				parse(data_source{std::move(attachment_data), file_extension{std::filesystem::path{name}}})});
+		}
+		return content;
+	}
+
+private:
+	std::shared_ptr<const pffFile> m_file;
+	std::optional<ParsingChain> m_chain;
+	std::vector<Tag>* m_tags = nullptr;
+
+	std::vector<Tag> parse(Tag tag)
+	{
+		std::vector<Tag> tags;
+		m_tags = &tags;
+		m_chain->process_in_place(tag, [](Tag&) { return ChainElement::continuation::proceed; });
+		m_tags = nullptr;
+		return tags;
+	}
+};
+
+/**
+	State of a single parse() call. It is not kept in the parser, because PST file nested in an attachment
+	can be parsed by the same parser while workers of the outer file are still running.
+*/
+struct ParseContext
+{
+	const data_source& m_data;
+	std::shared_ptr<const pffFile> m_file;
+	std::optional<data_source> m_worker_data;
+	std::vector<std::unique_ptr<MessageWorker>> m_workers;
+};
+
 } // anonymous namespace
 
-void pimpl_impl<PSTParser>::parse(std::shared_ptr<std::istream> stream) const
+template<>
+struct pimpl_impl<PSTParser> : with_pimpl_owner<PSTParser>
+{
+	pimpl_impl(PSTParser& owner, pst_message_workers message_workers, pst_worker_parsers worker_parsers)
+		: with_pimpl_owner{owner}, m_message_workers{message_workers}, m_worker_parsers{std::move(worker_parsers)} {}
+	void parse(const data_source& data);
+
+  private:
+    pst_message_workers m_message_workers;
+    pst_worker_parsers m_worker_parsers;
+
+    void parse_internal(ParseContext& context, const Folder& root, int deep, unsigned int &mail_counter);
+    void parseMessagesConcurrently(ParseContext& context, const Folder& root, int deep, unsigned int &mail_counter);
+    void sendMessage(ParseContext& context, MessageContent&& content, const std::function<Message()>& get_message, int deep, unsigned int &mail_counter) const;
+    void sendTags(std::vector<Tag>&& tags) const;
+};
+
+void pimpl_impl<PSTParser>::sendTags(std::vector<Tag>&& tags) const
 {
-	libpff_file_t* file = nullptr;
-	pffError error{nullptr};
-	if (libpff_file_initialize(&file, &error) != 1)
+	for (Tag& tag : tags)
+		owner().sendTag(std::move(tag));
+}
+
+/**
+	Message is read again only if its attachments were not read together with message content.
+*/
+void pimpl_impl<PSTParser>::sendMessage(ParseContext& context, MessageContent&& content, const std::function<Message()>& get_message, int deep, unsigned int &mail_counter) const
+{
+    if(content.m_html_body)
+    {
+      auto callback = owner().sendTag(tag::Mail{.subject = content.m_subject, .date = content.m_creation_date, .level = deep});
+      if(callback.skip)
+      {
+        return;
+      }
+      owner().sendTag(tag::MailBody{});
+      sendTags(std::move(*content.m_html_body));
+      ++mail_counter;
+      owner().sendTag(tag::CloseMailBody{});
+    }
+
+	if (content.m_attachments)
 	{
-		docwire_log(severity_level::error) << "Unable to initialize file.";
-		return;
+		for (AttachmentContent& attachment : *content.m_attachments)
+		{
+			file_extension extension { std::filesystem::path{attachment.m_name} };
+			auto callback = owner().sendTag(
+				tag::Attachment{.name = attachment.m_name, .size = attachment.m_size, .extension = extension});
+			if(callback.skip)
+			{
+				continue;
+			}
+			sendTags(std::move(attachment.m_tags));
+			owner().sendTag(tag::CloseAttachment{});
+		}
 	}
+	else
+	{
+		auto attachments = get_message().getAttachments(context.m_file);
+    for (auto &attachment : attachments)
+    {
+      file_extension extension { std::filesystem::path{attachment.m_name} };
+      auto callback = owner().sendTag(
+        tag::Attachment{.name = attachment.m_name, .size = attachment.m_size, .extension = extension});
+      if(callback.skip)
+      {
+        continue;
+      }
+      owner().sendTag(data_source{seekable_stream_ptr{std::move(attachment).stream()}, extension});
+      owner().sendTag(tag::CloseAttachment{});
+    }
+	}
+	owner().sendTag(tag::CloseMail{});
+}
+
+/**
+	Messages are read by worker threads, each with its own libpff file. If worker parsers are set,
+	workers also parse bodies and attachments, otherwise attachments are read lazily from the main file.
+	Messages are sent to the chain in folder order from the calling thread. Workers do not read more
+	than a few messages ahead of the calling thread, to limit memory used by messages waiting to be sent.
+*/
+void pimpl_impl<PSTParser>::parseMessagesConcurrently(ParseContext& context, const Folder& root, int deep, unsigned int &mail_counter)
+{
+	size_t message_count = root.getMessageNumber();
+	docwire_log_func_with_args(message_count, deep);
+	size_t workers_count = std::min<size_t>(m_message_workers.v, message_count);
+	if (!context.m_worker_data)
+	{
+		// Worker files read the memory already used by the main file, not the data source itself,
+		// so stream sources are not read again concurrently.
+		if (std::optional<std::filesystem::path> path = context.m_data.path())
+			context.m_worker_data.emplace(*path);
+		else
+			context.m_worker_data.emplace(context.m_data.span());
+	}
+	while (context.m_workers.size() < workers_count)
+		context.m_workers.push_back(std::make_unique<MessageWorker>(*context.m_worker_data, m_worker_parsers));
+	uint32_t folder_identifier = root.getIdentifier();
+	const size_t max_messages_ahead = 2 * workers_count;
+	std::vector<MessageContent> results(message_count);
+	std::mutex results_mutex;
+	std::condition_variable result_ready;
+	std::condition_variable message_sent;
+	size_t sent_messages = 0;
+	std::atomic<size_t> next_message{0};
+	std::atomic<bool> stopped{false};
+	auto worker = [&](MessageWorker& message_worker)
+	{
+		std::optional<Folder> folder;
+		for (size_t message_num = next_message++; message_num < message_count && !stopped; message_num = next_message++)
+		{
+			{
+				std::unique_lock<std::mutex> results_lock(results_mutex);
+				message_sent.wait(results_lock, [&]() { return message_num < sent_messages + max_messages_ahead || stopped; });
+			}
+			if (stopped)
+				break;
+			MessageContent result;
+			try
+			{
+				if (!folder)
+					folder.emplace(message_worker.file().getFolder(folder_identifier));
+				result = message_worker.readMessage(folder->getMessage(message_num));
+			}
+			catch (...)
+			{
+				result.m_failure = std::current_exception();
+			}
+			result.m_ready = true;
+			{
+				std::lock_guard<std::mutex> results_lock(results_mutex);
+				results[message_num] = std::move(result);
+			}
+			result_ready.notify_all();
+		}
+	};
+	std::vector<std::thread> threads;
+	auto stop_workers = [&]()
+	{
+		{
+			std::lock_guard<std::mutex> results_lock(results_mutex);
+			stopped = true;
+		}
+		message_sent.notify_all();
+		for (auto& thread : threads)
+			thread.join();
+	};
+	try
+	{
+		for (size_t i = 0; i < workers_count; i++)
+			threads.emplace_back(worker, std::ref(*context.m_workers[i]));
+		for (size_t message_num = 0; message_num < message_count; message_num++)
+		{
+			MessageContent result;
+			{
+				std::unique_lock<std::mutex> results_lock(results_mutex);
+				result_ready.wait(results_lock, [&]() { return results[message_num].m_ready; });
+				result = std::move(results[message_num]);
+				sent_messages = message_num + 1;
+			}
+			message_sent.notify_all();
+			if (result.m_failure)
+				std::rethrow_exception(result.m_failure);
+			sendMessage(context, std::move(result), [&]() { return root.getMessage(message_num); }, deep, mail_counter);
+		}
+	}
+	catch (...)
+	{
+		stop_workers();
+		throw;
+	}
+	stop_workers();
+}
 
-  libbfio_handle_t* handle = nullptr;
-    libbfio_error_t* bfio_error = nullptr;
-    libbfio_stream_initialize(&handle, stream);
-    libbfio_handle_open(handle, LIBBFIO_OPEN_READ_WRITE_TRUNCATE, &bfio_error);
-    libpff_file_open_file_io_handle(file, handle, LIBBFIO_OPEN_READ, &error);
+void pimpl_impl<PSTParser>::parse_internal(ParseContext& context, const Folder& root, int deep, unsigned int &mail_counter)
+{
+	for (int i = 0; i < root.getSubFolderNumber(); ++i)
+	{
+		auto sub_folder = root.getSubFolder(i);
+    auto callback = owner().sendTag(tag::Folder{.name = sub_folder.getName(), .level = deep});
+    if(callback.skip)
+    {
+      continue;
+    }
+    parse_internal(context, sub_folder, deep + 1, mail_counter);
+	owner().sendTag(tag::CloseFolder{});
+	}
+	if (m_message_workers.v > 1 && root.getMessageNumber() > 1)
+	{
+		parseMessagesConcurrently(context, root, deep, mail_counter);
+		return;
+	}
+	for (int i = 0; i < root.getMessageNumber(); ++i)
+	{
+		auto message = root.getMessage(i);
+		sendMessage(context, readMessageContent(message), [&]() { return std::move(message); }, deep, mail_counter);
+	}
+}
 
-	pffItem root = NULL;
-	libpff_file_get_root_folder(file, &root, &error);
-	Folder root_folder(std::move(root));
+void pimpl_impl<PSTParser>::parse(const data_source& data)
+{
+	ParseContext context{data, std::make_shared<const pffFile>(data)};
+	Folder root_folder = context.m_file->getRootFolder();
   unsigned int mail_counter = 0;
 	owner().sendTag(tag::Document{.metadata = []() { return attributes::Metadata{}; }});
-  parse_internal(root_folder, 0, mail_counter);
+  parse_internal(context, root_folder, 0, mail_counter);
 	owner().sendTag(tag::CloseDocument{});
-
-  if (file)
-  {
-    libpff_file_close(file, &error);
-    libpff_file_free(&file, &error);
-  }
-  if (handle)
-  {
-    libbfio_handle_close(handle, &bfio_error);
-    libbfio_handle_free(&handle, &bfio_error);
-    handle = nullptr;
-  }
-  libbfio_error_free(&bfio_error);
 }
 
 void
 PSTParser::parse(const data_source& data)
 {
 	docwire_log(debug) << "Using PST parser.";
-  std::shared_ptr<std::istream> stream = data.istream();
-	impl().parse(stream);
+	impl().parse(data);
 }
 
-PSTParser::PSTParser()
+PSTParser::PSTParser(pst_message_workers message_workers, pst_worker_parsers worker_parsers)
+	: with_pimpl<PSTParser>(message_workers, std::move(worker_parsers))
 {
 }
 
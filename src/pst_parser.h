@@ -13,14 +13,33 @@
 #ifndef DOCWIRE_PST_PARSER_H
 #define DOCWIRE_PST_PARSER_H
 
+#include <functional>
 #include <vector>
 
 #include "parser.h"
 #include "pimpl.h"
+#include "ref_or_owned.h"
 
 namespace docwire
 {
 
+/**
+	Number of threads reading messages of a single mailbox folder.
+	Values greater than one read message bodies and attachments concurrently, each thread with its own libpff file,
+	and send messages to the chain in folder order.
+*/
+struct pst_message_workers { unsigned int v; };
+
+/**
+	Creates chain element used by a single message worker to parse message bodies and attachments,
+	for example `[]() { return content_type::detector{} | office_formats_parser{}; }`.
+	Every worker creates its own element, so parsing of bodies and attachments is done concurrently too
+	and tags it produces are sent to the chain in message order. Data sources left unparsed by the element
+	are parsed by the chain on the calling thread. Skipping tags produced this way does not skip their content.
+	If not set, workers only read messages and bodies and attachments are parsed on the calling thread.
+*/
+struct pst_worker_parsers { std::function<ref_or_owned<ChainElement>()> v; };
+
 class DllExport PSTParser : public Parser, public with_pimpl<PSTParser>
 {
 private:
@@ -39,7 +58,7 @@ public:
     };
   };
 
-  PSTParser();
+  PSTParser(pst_message_workers message_workers = pst_message_workers{1}, pst_worker_parsers worker_parsers = pst_worker_parsers{});
 };
 
 } // namespace docwire
@@ -0,0 +1,150 @@
+/*********************************************************************************************************************************************/
+/*  DocWire SDK: Award-winning modern data processing in C++20. SourceForge Community Choice & Microsoft support. AI-driven processing.      */
+/*  Supports nearly 100 data formats, including email boxes and OCR. Boost efficiency in text extraction, web data extraction, data mining,  */
+/*  document analysis. Offline processing possible for security and confidentiality                                                          */
+/*                                                                                                                                           */
+/*  Copyright (c) SILVERCODERS Ltd, http://silvercoders.com                                                                                  */
+/*  Project homepage: https://github.com/docwire/docwire                                                                                     */
+/*                                                                                                                                           */
+/*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
+/*********************************************************************************************************************************************/
+
+#ifndef DOCWIRE_RESOURCE_POOL_H
+#define DOCWIRE_RESOURCE_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace docwire
+{
+
+/**
+ * @brief Pool of resources that are expensive to create, reused by many users.
+ *
+ * Resources are kept separately for every key. At most max_size resources for a key exist at once:
+ * if all of them are checked out, checkout waits until one of them is given back or discarded.
+ *
+ * @tparam Key Key type
+ * @tparam Resource Resource type, has to be movable
+ */
+template<typename Key, typename Resource>
+class resource_pool
+{
+public:
+    /**
+     * @brief Resource checked out of the pool.
+     *
+     * Resource is discarded if the lease is destroyed before give_back() is called,
+     * so resources left in unknown state by an exception are not reused.
+     */
+    class lease
+    {
+    public:
+        lease(lease&& other) noexcept
+            : m_pool{std::exchange(other.m_pool, nullptr)}, m_key{std::move(other.m_key)}, m_resource{std::move(other.m_resource)}
+        {}
+
+        lease& operator=(lease&&) = delete;
+
+        ~lease()
+        {
+            if (m_pool)
+                m_pool->discard(m_key);
+        }
+
+        Resource& operator*() { return *m_resource; }
+        Resource* operator->() { return &*m_resource; }
+
+        /**
+         * @brief Returns the resource to the pool, so it can be checked out again.
+         */
+        void give_back()
+        {
+            std::exchange(m_pool, nullptr)->give_back(m_key, std::move(*m_resource));
+        }
+
+    private:
+        friend resource_pool;
+
+        lease(resource_pool& pool, const Key& key, Resource&& resource)
+            : m_pool{&pool}, m_key{key}, m_resource{std::move(resource)}
+        {}
+
+        resource_pool* m_pool;
+        Key m_key;
+        std::optional<Resource> m_resource;
+    };
+
+    /**
+     * @brief Checks out an idle resource for specified key or creates a new one with producer function.
+     * @param key Key of the resource
+     * @param max_size Maximum number of resources for the key, checked out or idle, at least one
+     * @param producer Function that creates a new resource for specified key. It is called without the pool locked.
+     * @return Lease of the resource
+     */
+    lease checkout(const Key& key, size_t max_size, const std::function<Resource(const Key&)>& producer)
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        resources& key_resources = m_resources[key];
+        m_resource_released.wait(lock, [&]()
+        {
+            return !key_resources.idle.empty() || key_resources.count < std::max<size_t>(max_size, 1);
+        });
+        if (!key_resources.idle.empty())
+        {
+            Resource resource = std::move(key_resources.idle.back());
+            key_resources.idle.pop_back();
+            return lease{*this, key, std::move(resource)};
+        }
+        ++key_resources.count;
+        lock.unlock();
+        try
+        {
+            return lease{*this, key, producer(key)};
+        }
+        catch (...)
+        {
+            discard(key);
+            throw;
+        }
+    }
+
+private:
+    struct resources
+    {
+        std::vector<Resource> idle;
+        size_t count = 0; // idle and checked out
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_resource_released;
+    std::map<Key, resources> m_resources;
+
+    void give_back(const Key& key, Resource&& resource)
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_resources[key].idle.push_back(std::move(resource));
+        }
+        m_resource_released.notify_all();
+    }
+
+    void discard(const Key& key)
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            --m_resources[key].count;
+        }
+        m_resource_released.notify_all();
+    }
+};
+
+} // namespace docwire
+
+#endif // DOCWIRE_RESOURCE_POOL_H
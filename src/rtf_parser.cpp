@@ -16,7 +16,6 @@
 #include "log.h"
 #include <map>
 #include "misc.h"
-#include <mutex>
 #include <sstream>
 #include <stack>
 #include <stdio.h>
@@ -472,11 +471,6 @@ static void execCommand(DataStream& data_stream, UString& text, int& skip, RTFPa
 	}
 }
 
-namespace
-{
-	std::mutex converter_mutex;
-} // anonymous namespace
-
 void RTFParser::parse(const data_source& data)
 {
 	docwire_log(debug) << "Using RTF parser.";
@@ -508,10 +502,7 @@ void RTFParser::parse(const data_source& data)
 					if (!parseCommand(*stream, cmd, arg))
 						break;
 					UString fragment_text;
-					{
-						std::lock_guard<std::mutex> converter_mutex_lock(converter_mutex);
-						execCommand(*stream, fragment_text, skip, state, cmd, arg, converter, [this](std::exception_ptr e) { sendTag(e); });
-					}
+					execCommand(*stream, fragment_text, skip, state, cmd, arg, converter, [this](std::exception_ptr e) { sendTag(e); });
 					switch (state.groups.top().destination)
 					{
 						case destination_type::annotation:
@@ -12,9 +12,10 @@
 #include "txt_parser.h"
 
 #include "charsetdetect.h"
-#include "htmlcxx/html/CharsetConverter.h"
+#include "charset_converter.h"
 #include "log.h"
 #include "make_error.h"
+#include <optional>
 #include "pimpl.h"
 #include <string.h>
 
@@ -76,7 +77,6 @@ void TXTParser::parse(const data_source& data)
 	docwire_log(debug) << "Using TXT parser.";
 	std::string text;
 	csd_t charset_detector = NULL;
-	htmlcxx::CharsetConverter* converter = NULL;
 	try
 	{
 		std::string encoding;
@@ -106,34 +106,22 @@ void TXTParser::parse(const data_source& data)
 				content = sequences_of_printable_characters(content);
 			}
 		}
-		if (encoding != "utf-8" && encoding != "UTF-8")
+		std::optional<charset_converter> converter;
+		try
 		{
-			try
-			{
-				converter = new htmlcxx::CharsetConverter(encoding, "UTF-8");
-			}
-			catch (htmlcxx::CharsetConverter::Exception& ex)
-			{
-				sendTag(make_nested_ptr(ex, make_error("Cannot convert text to UTF-8", encoding)));
-				if (converter)
-					delete converter;
-				converter = NULL;
-			}
+			converter.emplace(encoding);
 		}
-		if (converter)
+		catch (const std::exception& e)
 		{
-			text = converter->convert(content);
-			delete converter;
-			converter = NULL;
+			sendTag(make_nested_ptr(e, make_error("Cannot convert text to UTF-8", encoding)));
 		}
+		if (converter)
+			text = converter->to_utf8(content);
 		else
-			text = content;
+			text = std::move(content);
 	}
 	catch (const std::exception& e)
 	{
-		if (converter)
-			delete converter;
-		converter = NULL;
 		if (charset_detector)
 			csd_close(charset_detector);
 		charset_detector = NULL;
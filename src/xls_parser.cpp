@@ -16,7 +16,6 @@
 #include <map>
 #include <math.h>
 #include "misc.h"
-#include <mutex>
 #include "oshared.h"
 #include <set>
 #include <stdio.h>
@@ -36,12 +35,6 @@ using namespace wvWare;
 namespace docwire
 {
 
-namespace
-{
-	std::mutex xls_converter_mutex;
-	std::mutex parser_mutex;
-} // anonymous namespace
-
 enum RecordType
 {
 	XLS_BOF = 0x809,
@@ -71,6 +64,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 {
 	pimpl_impl(XLSParser& owner) : with_pimpl_owner{owner} {}
 	std::string m_codepage = "cp1251";
+	std::unique_ptr<TextConverter> m_converter;
 	enum BiffVersion { BIFF2, BIFF3, BIFF4, BIFF5, BIFF8 };
 	BiffVersion m_biff_version;
 	struct XFRecord
@@ -87,6 +81,10 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 	int m_last_string_formula_col;
 	std::set<int> m_defined_num_format_ids;
 	int m_last_row, m_last_col;
+	bool m_send_tags = false;
+	bool m_table_open = false;
+	bool m_row_open = false;
+	bool m_cells_sent = false;
 
 	U16 getU16LittleEndian(std::vector<unsigned char>::const_iterator buffer)
 	{
@@ -356,9 +354,9 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				std::string c2(1, *s);
 				if (m_codepage != "ASCII")
 				{
-					std::lock_guard<std::mutex> xls_converter_mutex_lock(xls_converter_mutex);
-					TextConverter tc(m_codepage);
-					dest += ustring_to_string(tc.convert(c2));
+					if (!m_converter)
+						m_converter = std::make_unique<TextConverter>(m_codepage);
+					dest += ustring_to_string(m_converter->convert(c2));
 				}
 				else
 					dest += c2;
@@ -406,6 +404,63 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 		return r;
 	}
 
+	/**
+		Cells are sent as table tags as soon as they are decoded, one table per sheet, if m_send_tags is set.
+		Otherwise they are appended to text, separated by tabs and new lines.
+		Empty rows and cells are added in place of missing ones, so cells keep their positions.
+	*/
+	void addCell(int row, int col, const std::string& s, std::string& text)
+	{
+		if (!m_send_tags)
+		{
+			text += cellText(row, col, s);
+			return;
+		}
+		if (!m_table_open)
+		{
+			owner().sendTag(tag::Table{});
+			m_table_open = true;
+		}
+		if (m_row_open && row > m_last_row)
+		{
+			owner().sendTag(tag::CloseTableRow{});
+			m_row_open = false;
+			++m_last_row;
+		}
+		if (!m_row_open)
+		{
+			for (; m_last_row < row; ++m_last_row)
+			{
+				owner().sendTag(tag::TableRow{});
+				owner().sendTag(tag::CloseTableRow{});
+			}
+			owner().sendTag(tag::TableRow{});
+			m_row_open = true;
+			m_last_col = 0;
+		}
+		for (; m_last_col < col; ++m_last_col)
+		{
+			owner().sendTag(tag::TableCell{});
+			owner().sendTag(tag::CloseTableCell{});
+		}
+		owner().sendTag(tag::TableCell{});
+		if (!s.empty())
+			owner().sendTag(tag::Text{.text = s});
+		owner().sendTag(tag::CloseTableCell{});
+		++m_last_col;
+		m_cells_sent = true;
+	}
+
+	void closeTable()
+	{
+		if (m_row_open)
+			owner().sendTag(tag::CloseTableRow{});
+		if (m_table_open)
+			owner().sendTag(tag::CloseTable{});
+		m_row_open = false;
+		m_table_open = false;
+	}
+
 	void processRecord(int rec_type, const std::vector<unsigned char>& rec, std::string& text)
 	{
 		docwire_log(debug) << hex() << "record" << rec_type;
@@ -422,11 +477,13 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				}
 				int row = getU16LittleEndian(rec.begin());
 				int col = getU16LittleEndian(rec.begin() + 2);
-				text += cellText(row, col, "");
+				addCell(row, col, "", text);
 				break;
 			}
 			case XLS_BOF:
 			{
+				if (m_send_tags)
+					closeTable();
 				m_last_row = 0;
 				m_last_col = 0;
 				// warning TODO: Check for stream type, ignore charts, or make it configurable
@@ -444,6 +501,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 						m_codepage = "ASCII";
 					else
 						m_codepage = "cp" + int2string(codepage);
+					m_converter.reset();
 				}
 				break;
 			}
@@ -462,7 +520,10 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				break;
 			case XLS_EOF:
 			{
-				text += "\n";
+				if (m_send_tags)
+					closeTable();
+				else
+					text += "\n";
 				// warning TODO: Mark end of sheet (configurable)
 				break;
 			}
@@ -517,15 +578,15 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 					else if (rec[6] == 1)
 					{
 						// warning TODO: check and test boolean formulas
-						text += (rec[8] ? "TRUE" : "FALSE");
+						addCell(row, col, rec[8] ? "TRUE" : "FALSE", text);
 					}
 					else if (rec[6] == 2)
-						text += "ERROR";
+						addCell(row, col, "ERROR", text);
 				}
 				else
 				{
 					int xf_index=getU16LittleEndian(rec.begin()+4);
-					text += cellText(row, col, parseXNum(rec.begin() + 6,xf_index));
+					addCell(row, col, parseXNum(rec.begin() + 6,xf_index), text);
 				}
 				break;
 			}
@@ -538,7 +599,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				}
 				int row = getU16LittleEndian(rec.begin());
 				int col = getU16LittleEndian(rec.begin()+2);
-				text += cellText(row, col, int2string(getU16LittleEndian(rec.begin() + 7)));
+				addCell(row, col, int2string(getU16LittleEndian(rec.begin() + 7)), text);
 				break;
 			}
 			case XLS_RSTRING:
@@ -557,7 +618,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				sizes.push_back(rec.size() - 6);
 				size_t record_index = 0;
 				size_t record_pos = 0;
-				text += cellText(row, col, parseXLUnicodeString(&src, rec.end(), sizes, record_index, record_pos));
+				addCell(row, col, parseXLUnicodeString(&src, rec.end(), sizes, record_index, record_pos), text);
 				break;
 			}
 			case XLS_LABEL_SST:
@@ -577,7 +638,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 					return;
 				}
 				else
-					text += cellText(row, col, m_shared_string_table[sst_index]);
+					addCell(row, col, m_shared_string_table[sst_index], text);
 				break;
 			}
 			case XLS_MULBLANK:
@@ -591,7 +652,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				int start_col = getU16LittleEndian(rec.begin() + 2);
 				int end_col=getU16LittleEndian(rec.begin() + rec.size() - 2);
 				for (int c = start_col; c <= end_col; c++)
-					text += cellText(row, c, "");
+					addCell(row, c, "", text);
 				break;
 			}
 			case XLS_MULRK:
@@ -614,7 +675,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				for (int offset = 4, col = start_col; col <= end_col; offset += 6, col++)
 				{
 					int xf_index = getU16LittleEndian(rec.begin() + offset);
-					text += cellText(row, col, parseRkRec(rec.begin() + offset + 2, xf_index));
+					addCell(row, col, parseRkRec(rec.begin() + offset + 2, xf_index), text);
 				}
 				break;
 			}
@@ -631,7 +692,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				m_last_string_formula_row = -1;
 				int row = getU16LittleEndian(rec.begin());
 				int col = getU16LittleEndian(rec.begin() + 2);
-				text += cellText(row, col, parseXNum(rec.begin() + 6, getU16LittleEndian(rec.begin() + 4)));
+				addCell(row, col, parseXNum(rec.begin() + 6, getU16LittleEndian(rec.begin() + 4)), text);
 				break;
 			}
 			case XLS_RK:
@@ -645,7 +706,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				int row = getU16LittleEndian(rec.begin());
 				int col = getU16LittleEndian(rec.begin() + 2);
 				int xf_index = getU16LittleEndian(rec.begin() + 4);
-				text += cellText(row, col, parseRkRec(rec.begin() + 6, xf_index));
+				addCell(row, col, parseRkRec(rec.begin() + 6, xf_index), text);
 				break;
 			}
 			case XLS_SST:
@@ -669,7 +730,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 				sizes.push_back(rec.size());
 				size_t record_index = 0;
 				size_t record_pos = 0;
-				text += cellText(m_last_string_formula_row, m_last_string_formula_col, parseXLUnicodeString(&src, rec.end(), sizes, record_index, record_pos));
+				addCell(m_last_string_formula_row, m_last_string_formula_col, parseXLUnicodeString(&src, rec.end(), sizes, record_index, record_pos), text);
 				break;
 			}
 			case XLS_XF:
@@ -813,7 +874,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 			}
 			catch (const std::exception& e)
 			{
-				if (text.length() == 0)
+				if (text.empty() && !m_cells_sent)
 					std::throw_with_nested(make_error("Type of record could not be read"));
 				else
 					non_fatal_error_handler(errors::make_nested_ptr(e, make_error("Type of record could not be read")));
@@ -831,7 +892,7 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 			}
 			catch (const std::exception& e)
 			{
-				if (text.length() == 0)
+				if (text.empty() && !m_cells_sent)
 					std::throw_with_nested(make_error("Length of record could not be read"));
 				else
 					non_fatal_error_handler(errors::make_nested_ptr(e, make_error("Length of record could not be read")));
@@ -857,6 +918,8 @@ struct pimpl_impl<XLSParser> : with_pimpl_owner<XLSParser>
 			else
 				eof_rec_found = false;	
 		}
+		if (m_send_tags)
+			closeTable(); // sheet truncated before its EOF record
 	}
 };
 
@@ -884,18 +947,23 @@ void XLSParser::parse(const data_source& data)
 				}
 			}
 		});
-	sendTag(tag::Text{.text = parse(*storage)});
+	parse(*storage, true);
 	sendTag(tag::CloseDocument{});
 }
 
 std::string XLSParser::parse(ThreadSafeOLEStorage& storage)
+{
+	return parse(storage, false);
+}
+
+std::string XLSParser::parse(ThreadSafeOLEStorage& storage, bool send_tags)
 {
 	renew_impl();
 	docwire_log(debug) << "Using XLS parser.";
+	impl().m_send_tags = send_tags;
 
 	try
 	{
-		std::lock_guard<std::mutex> parser_mutex_lock(parser_mutex);
 		std::unique_ptr<ThreadSafeOLEStreamReader> workbook_reader { static_cast<ThreadSafeOLEStreamReader*>(storage.createStreamReader("Workbook")) };
 		std::string text;
 		if (workbook_reader != nullptr)
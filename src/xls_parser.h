@@ -27,6 +27,7 @@ class DllExport XLSParser : public Parser, public with_pimpl<XLSParser>
 		friend pimpl_impl<XLSParser>;
 		using with_pimpl<XLSParser>::impl;
 		using with_pimpl<XLSParser>::renew_impl;
+		std::string parse(ThreadSafeOLEStorage& storage, bool send_tags);
 
 	public:
 		XLSParser();
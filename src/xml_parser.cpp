@@ -21,7 +21,7 @@ namespace docwire
 namespace
 {
 
-void parseXmlData(std::function<void(const Tag&)> send_tag, XmlStream& xml_stream)
+void parseXmlData(std::function<void(Tag&&)> send_tag, XmlStream& xml_stream)
 {
 	while (xml_stream)
 	{
@@ -32,8 +32,7 @@ void parseXmlData(std::function<void(const Tag&)> send_tag, XmlStream& xml_strea
 			char* content = xml_stream.content();
 			if (content != NULL)
 			{
-				std::string text = content;
-				send_tag(tag::Text{ text });
+				send_tag(tag::Text{ content });
 			}
 		}
 		else if (tag_name != "style" && full_tag_name != "o:DocumentProperties" &&
@@ -61,7 +60,7 @@ void XMLParser::parse(const data_source& data)
 	sendTag(tag::Document{});
 	std::string xml_content = data.string();
 	XmlStream xml_stream(xml_content);
-	parseXmlData([this](const Tag& tag) { this->sendTag(tag); }, xml_stream);
+	parseXmlData([this](Tag&& tag) { this->sendTag(std::move(tag)); }, xml_stream);
 	sendTag(tag::CloseDocument{});
 }
 
@@ -17,6 +17,7 @@
 #include "log.h"
 #include <mutex>
 #include "throw_if.h"
+#include "zip_reader.h"
 
 namespace docwire
 {
@@ -68,16 +69,16 @@ class LibXml2InitAndCleanup
  * Creates a unique pointer to an xmlTextReader object safely.
  *
  * This function safely creates a unique pointer to an xmlTextReader object, ensuring proper memory management and thread safety.
- * It provides a safer and more efficient way to handle the creation and destruction of xmlTextReader objects compared to directly using xmlReaderForMemory. 
+ * It provides a safer and more efficient way to handle the creation and destruction of xmlTextReader objects compared to directly using xmlReaderForMemory or xmlReaderForIO.
  * It leverages std::unique_ptr for automatic memory management and introduces a locking mechanism for thread safety.
  * libxml2 is initialized if needed and cleaned up on application exit.
  *
- * @param xml The XML string to be parsed.
- * @param xml_parse_options The options for parsing the XML.
+ * @param create_reader The function creating xmlTextReader object, called under lock.
  *
  * @return A unique pointer to an xmlTextReader object. Ownership is transferred to the caller.
  */
-static std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)> make_xml_text_reader_safely(const std::string& xml, int xml_parse_options)
+template <typename CreateReader>
+std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)> make_xml_text_reader_safely(CreateReader create_reader)
 {
 	// xmlParserInit() is called both from LibXml2InitAndCleanup and from xmlReaderForMemory.
 	// libxml2 can be initialized and deinitialized multiple times because it checkes the value of
@@ -86,27 +87,76 @@ static std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)> make_xml_tex
 	// Init libxml2 immediately, but cleanup at application exit not to interfere with other threads or
 	// other code that uses libxml2.
 	static LibXml2InitAndCleanup init_and_cleanup{};
-	return std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)>(
-		xmlReaderForMemory(xml.c_str(), xml.length(), NULL, NULL,
-			xml_parse_options | XML_PARSE_NOERROR | XML_PARSE_NOWARNING),
-		&xmlFreeTextReader);
+	return std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)>(create_reader(), &xmlFreeTextReader);
 }
 
-} // anonymous namespace
+/**
+ * Input of xmlTextReader decompressing file from zip archive chunk by chunk.
+ *
+ * Has its own reader of the archive, because ZipReader can have only one file opened for reading in chunks
+ * and the archive is used by command handlers during parsing. Both readers work on the same memory,
+ * because data source does not reallocate its content once it has been read in full.
+ */
+struct zip_entry_input
+{
+	ZipReader zipfile;
+	std::string file_name;
+	bool eof = false;
+
+	zip_entry_input(const data_source& data, const std::string& file_name)
+		: zipfile(data), file_name(file_name)
+	{
+		zipfile.open();
+		throw_if (!zipfile.exists(file_name), "File does not exist in zip archive", file_name);
+	}
+
+	static int read(void* context, char* buffer, int len)
+	{
+		zip_entry_input* input = static_cast<zip_entry_input*>(context);
+		if (input->eof || len <= 1)
+			return 0;
+		int readed;
+		// readChunk() writes terminating zero after the data.
+		if (!input->zipfile.readChunk(input->file_name, buffer, len - 1, readed))
+			return -1;
+		if (readed < len - 1)
+			input->eof = true;
+		return readed;
+	}
+};
 
-// warning TODO: Maybe it will be good direction if XmlStream will not require loading whole xml data at once? For now\
-	if we want to parse one of OOXML/ODF/ODFXML files we need to load whole file into memory at once. It would be good\
-	if XmlStream was more frugal
+} // anonymous namespace
 
 template<>
 struct pimpl_impl<XmlStream> : pimpl_impl_base
 {
 	bool m_badbit = false;
+	std::unique_ptr<zip_entry_input> m_zip_entry_input;
 	std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)> m_reader;
 	int m_curr_depth;
 
 	pimpl_impl(const std::string& xml, int xml_parse_options)
-		: m_reader(make_xml_text_reader_safely(xml, xml_parse_options))
+		: m_reader(make_xml_text_reader_safely([&]()
+			{
+				return xmlReaderForMemory(xml.c_str(), xml.length(), NULL, NULL,
+					xml_parse_options | XML_PARSE_NOERROR | XML_PARSE_NOWARNING);
+			}))
+	{
+		init();
+	}
+
+	pimpl_impl(const ZipReader& zipfile, const std::string& file_name, int xml_parse_options)
+		: m_zip_entry_input(std::make_unique<zip_entry_input>(zipfile.data(), file_name)),
+		  m_reader(make_xml_text_reader_safely([&]()
+			{
+				return xmlReaderForIO(&zip_entry_input::read, NULL, m_zip_entry_input.get(), NULL, NULL,
+					xml_parse_options | XML_PARSE_NOERROR | XML_PARSE_NOWARNING);
+			}))
+	{
+		init();
+	}
+
+	void init()
 	{
 		throw_if (m_reader == NULL, "Cannot initialize xmlTextReader");
 		throw_if (!read_next(), "Cannot initialize xmlTextReader");
@@ -141,6 +191,11 @@ XmlStream::XmlStream(const std::string &xml, int xml_parse_options)
 {
 }
 
+XmlStream::XmlStream(const ZipReader& zipfile, const std::string& file_name, int xml_parse_options)
+	: with_pimpl(zipfile, file_name, xml_parse_options)
+{
+}
+
 XmlStream::operator bool()
 {
 	return !impl().m_badbit;
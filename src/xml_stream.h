@@ -19,10 +19,18 @@
 namespace docwire
 {
 
+class ZipReader;
+
 class DllExport XmlStream : public with_pimpl<XmlStream>
 {
 	public:
 		XmlStream(const std::string& xml, int xml_parse_options = 0);
+		/**
+			Parses xml file stored in zip archive. File is decompressed in small chunks on demand while parsing,
+			so it is never loaded into memory as a whole. Separate reader of the archive is used internally,
+			so zipfile can be used to read other files while the stream is parsed.
+		**/
+		XmlStream(const ZipReader& zipfile, const std::string& file_name, int xml_parse_options = 0);
 		operator bool();
 		void next();
 		void levelDown();
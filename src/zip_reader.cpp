@@ -11,7 +11,10 @@
 
 #include "zip_reader.h"
 
-#include <map>
+#include <algorithm>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -101,19 +104,120 @@ static int buffer_error(voidpf opaque, voidpf stream)
 	return 0;	//no errors at all?
 }
 
+struct zip_entry
+{
+	unz_file_pos pos;
+	unsigned long uncompressed_size;
+};
+
+struct zip_directory
+{
+	std::unordered_map<std::string, zip_entry> entries;
+	std::vector<std::string_view> sorted_names; // keys of entries in sorted order for prefix lookups
+};
+
 template<>
 struct pimpl_impl<ZipReader> : pimpl_impl_base
 {
 	unzFile ArchiveFile;
-	std::map<std::string, unz_file_pos> m_directory;
+	std::shared_ptr<const zip_directory> m_directory;
 	bool m_opened_for_chunks;
+	const data_source* m_data;
 	std::span<const std::byte> m_span;
 	ZippedBuffer* m_zipped_buffer;
+
+	int locate_file(const std::string& file_name) const
+	{
+		if (m_directory)
+		{
+			auto i = m_directory->entries.find(file_name);
+			if (i == m_directory->entries.end())
+				return UNZ_END_OF_LIST_OF_FILE;
+			unz_file_pos pos = i->second.pos;
+			return unzGoToFilePos(ArchiveFile, &pos);
+		}
+		else
+			return unzLocateFile(ArchiveFile, file_name.c_str(), CASESENSITIVITY);
+	}
+
+	/**
+		Inflates located file directly into destination. Uncompressed size from central directory is used to
+		allocate memory once, but it is not trusted blindly: preallocation is limited by maximum deflate ratio
+		and destination grows if the file turns out to be bigger than declared.
+	**/
+	bool read_file(const std::string& file_name, std::string& destination, size_t max_size)
+	{
+		if (locate_file(file_name) != UNZ_OK)
+			return false;
+		unz_file_info file_info;
+		if (unzGetCurrentFileInfo(ArchiveFile, &file_info, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
+			return false;
+		if (unzOpenCurrentFile(ArchiveFile) != UNZ_OK)
+			return false;
+		constexpr size_t max_deflate_ratio = 1032;
+		constexpr size_t min_block_size = 64 * 1024;
+		constexpr size_t max_block_size = 1024 * 1024 * 1024;
+		size_t expected_size = std::min<size_t>(file_info.uncompressed_size, file_info.compressed_size * max_deflate_ratio);
+		destination.resize(std::min(expected_size > 0 ? expected_size : min_block_size, max_size));
+		size_t size = 0;
+		for (;;)
+		{
+			if (size == destination.size())
+			{
+				if (size == max_size || unzeof(ArchiveFile))
+					break;
+				destination.resize(std::min(std::max(size * 2, min_block_size), max_size));
+			}
+			int res = unzReadCurrentFile(ArchiveFile, destination.data() + size,
+				static_cast<unsigned>(std::min(destination.size() - size, max_block_size)));
+			if (res < 0)
+			{
+				unzCloseCurrentFile(ArchiveFile);
+				destination.clear();
+				return false;
+			}
+			if (res == 0)
+				break;
+			size += res;
+		}
+		destination.resize(size);
+		unzCloseCurrentFile(ArchiveFile);
+		return true;
+	}
+
+	std::shared_ptr<const zip_directory> read_directory() const
+	{
+		auto directory = std::make_shared<zip_directory>();
+		if (unzGoToFirstFile(ArchiveFile) != UNZ_OK)
+			return nullptr;
+		for (;;)
+		{
+			char name[1024];
+			unz_file_info file_info;
+			if (unzGetCurrentFileInfo(ArchiveFile, &file_info, name, 1024, NULL, 0, NULL, 0) != UNZ_OK)
+				return nullptr;
+			unz_file_pos pos;
+			if (unzGetFilePos(ArchiveFile, &pos) != UNZ_OK)
+				return nullptr;
+			directory->entries.try_emplace(name, zip_entry{pos, file_info.uncompressed_size});
+			int res = unzGoToNextFile(ArchiveFile);
+			if (res == UNZ_END_OF_LIST_OF_FILE)
+				break;
+			if (res != UNZ_OK)
+				return nullptr;
+		}
+		directory->sorted_names.reserve(directory->entries.size());
+		for (const auto& entry : directory->entries)
+			directory->sorted_names.push_back(entry.first);
+		std::sort(directory->sorted_names.begin(), directory->sorted_names.end());
+		return directory;
+	}
 };
 
 ZipReader::ZipReader(const data_source& data)
 {
 		impl().m_opened_for_chunks = false;
+		impl().m_data = &data;
 		impl().m_span = data.span();
 		impl().ArchiveFile = NULL;
 		impl().m_zipped_buffer = NULL;
@@ -144,50 +248,33 @@ void ZipReader::open()
 		//this function allows us to override default behaviour (reading from hard disc)
 		impl().ArchiveFile = unzOpen2("stream", &read_from_buffer_functions);
 	throw_if (impl().ArchiveFile == NULL, "Could not open zip archive");
+	// Central directory is read only once per data source. Content type detectors and parser
+	// opening the same data source share the index and do not scan the directory for every file lookup.
+	impl().m_directory = impl().m_data->cached<zip_directory>([this]() { return impl().read_directory(); });
+}
+
+const data_source& ZipReader::data() const
+{
+	return *impl().m_data;
 }
 
 bool ZipReader::exists(const std::string& file_name) const
 {
+	if (impl().m_directory)
+		return impl().m_directory->entries.count(file_name) > 0;
 	return (unzLocateFile(impl().ArchiveFile, file_name.c_str(), CASESENSITIVITY) == UNZ_OK);
 }
 
 bool ZipReader::read(const std::string& file_name, std::string* contents, int num_of_chars)
 {
-	int res;
-	if (impl().m_directory.size() > 0)
-	{
-		std::map<std::string, unz_file_pos>::iterator i = impl().m_directory.find(file_name);
-		if (i == impl().m_directory.end())
-			return false;
-		res = unzGoToFilePos(impl().ArchiveFile, &i->second);
-	}
-	else
-		res = unzLocateFile(impl().ArchiveFile, file_name.c_str(), CASESENSITIVITY);
-	if (res != UNZ_OK)
-		return false;
-	res = unzOpenCurrentFile(impl().ArchiveFile);
-	if (res != UNZ_OK)
-		return false;
-	*contents = "";
-	char buffer[1024 + 1];
-	while((res = unzReadCurrentFile(impl().ArchiveFile, buffer, (num_of_chars > 0 && num_of_chars < 1024) ? num_of_chars : 1024)) > 0)
-	{
-		buffer[res] = '\0';
-		*contents += buffer;
-		if (num_of_chars > 0)
-			if (contents->length() >= num_of_chars)
-			{
-				*contents = contents->substr(0, num_of_chars);
-				break;
-			}
-	}
-	if (res < 0)
-	{
-		unzCloseCurrentFile(impl().ArchiveFile);
-		return false;
-	}
-	unzCloseCurrentFile(impl().ArchiveFile);
-	return true;
+	return impl().read_file(file_name, *contents, num_of_chars > 0 ? num_of_chars : std::numeric_limits<size_t>::max());
+}
+
+std::optional<std::span<const char>> ZipReader::readToBuffer(const std::string& file_name, std::string& buffer)
+{
+	if (!impl().read_file(file_name, buffer, std::numeric_limits<size_t>::max()))
+		return std::nullopt;
+	return std::span<const char>{buffer.data(), buffer.size()};
 }
 
 void ZipReader::closeReadingFileForChunks()
@@ -200,15 +287,7 @@ bool ZipReader::readChunk(const std::string& file_name, char* contents, int num_
 	if (impl().m_opened_for_chunks == false)
 	{
 		int res;
-		if (impl().m_directory.size() > 0)
-		{
-			std::map<std::string, unz_file_pos>::iterator i = impl().m_directory.find(file_name);
-			if (i == impl().m_directory.end())
-				return false;
-			res = unzGoToFilePos(impl().ArchiveFile, &i->second);
-		}
-		else
-			res = unzLocateFile(impl().ArchiveFile, file_name.c_str(), CASESENSITIVITY);
+		res = impl().locate_file(file_name);
 		if (res != UNZ_OK)
 			return false;
 		res = unzOpenCurrentFile(impl().ArchiveFile);
@@ -246,19 +325,45 @@ bool ZipReader::readChunk(const std::string& file_name, std::string* contents, i
 	return true;
 }
 
+std::vector<std::string> ZipReader::list(const std::string& prefix) const
+{
+	std::vector<std::string> names;
+	if (!impl().m_directory)
+	{
+		// Directory index could not be read completely, so list files that can still be walked through.
+		if (unzGoToFirstFile(impl().ArchiveFile) != UNZ_OK)
+			return names;
+		do
+		{
+			char name[1024];
+			if (unzGetCurrentFileInfo(impl().ArchiveFile, NULL, name, 1024, NULL, 0, NULL, 0) != UNZ_OK)
+				break;
+			if (std::string_view{name}.starts_with(prefix))
+				names.emplace_back(name);
+		} while (unzGoToNextFile(impl().ArchiveFile) == UNZ_OK);
+		std::sort(names.begin(), names.end());
+		return names;
+	}
+	const std::vector<std::string_view>& sorted_names = impl().m_directory->sorted_names;
+	for (auto i = std::lower_bound(sorted_names.begin(), sorted_names.end(), std::string_view{prefix});
+			i != sorted_names.end() && i->starts_with(prefix); ++i)
+		names.emplace_back(*i);
+	return names;
+}
+
 bool ZipReader::getFileSize(const std::string& file_name, unsigned long& file_size)
 {
-	int res;
-	unz_file_info file_info;
-	if (impl().m_directory.size() > 0)
+	if (impl().m_directory)
 	{
-		std::map<std::string, unz_file_pos>::iterator i = impl().m_directory.find(file_name);
-		if (i == impl().m_directory.end())
+		auto i = impl().m_directory->entries.find(file_name);
+		if (i == impl().m_directory->entries.end())
 			return false;
-		res = unzGoToFilePos(impl().ArchiveFile, &i->second);
+		file_size = i->second.uncompressed_size;
+		return true;
 	}
-	else
-		res = unzLocateFile(impl().ArchiveFile, file_name.c_str(), CASESENSITIVITY);
+	int res;
+	unz_file_info file_info;
+	res = impl().locate_file(file_name);
 	if (res != UNZ_OK)
 		return false;
 	if (unzGetCurrentFileInfo(impl().ArchiveFile, &file_info, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
@@ -269,25 +374,9 @@ bool ZipReader::getFileSize(const std::string& file_name, unsigned long& file_si
 
 bool ZipReader::loadDirectory()
 {
-	impl().m_directory.clear();
-	if (unzGoToFirstFile(impl().ArchiveFile) != UNZ_OK)
-		return false;
-	for (;;)
-	{
-		char name[1024];
-		if (unzGetCurrentFileInfo(impl().ArchiveFile, NULL, name, 1024, NULL, 0, NULL, 0) != UNZ_OK)
-			return false;
-		unz_file_pos pos;
-		if (unzGetFilePos(impl().ArchiveFile, &pos) != UNZ_OK)
-			return false;
-		impl().m_directory[name] = pos;
-		int res = unzGoToNextFile(impl().ArchiveFile);
-		if (res == UNZ_END_OF_LIST_OF_FILE)
-			break;
-		if (res != UNZ_OK)
-			return false;
-	}
-	return true;
+	if (!impl().m_directory)
+		impl().m_directory = impl().m_data->cached<zip_directory>([this]() { return impl().read_directory(); });
+	return impl().m_directory != nullptr;
 }
 
 }; // namespace docwire
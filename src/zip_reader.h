@@ -13,7 +13,10 @@
 #define DOCWIRE_ZIP_READER_H
 
 #include "data_source.h"
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
 #include "defines.h"
 #include "pimpl.h"
 
@@ -26,14 +29,28 @@ class DllExport ZipReader : public with_pimpl<ZipReader>
 		ZipReader(const data_source& data);
 		~ZipReader();
 		void open();
+		const data_source& data() const;
 		bool exists(const std::string& file_name) const;
+		/**
+			Returns sorted names of all files whose names start with prefix, e.g. list("ppt/slides/").
+			Uses directory index. If the directory could not be read, files are listed by walking the archive
+			up to the first unreadable entry.
+		**/
+		std::vector<std::string> list(const std::string& prefix = "") const;
 		bool read(const std::string& file_name, std::string* contents, int num_of_chars = 0);
+		/**
+			Reads whole file into the buffer and returns its contents or nullopt if file cannot be read.
+			Buffer memory is reused, so reading many files with the same buffer allocates only when a file is bigger than previous ones.
+		**/
+		std::optional<std::span<const char>> readToBuffer(const std::string& file_name, std::string& buffer);
 		bool getFileSize(const std::string& file_name, unsigned long& file_size);
 		bool readChunk(const std::string& file_name, std::string* contents, int chunk_size);
 		bool readChunk(const std::string& file_name, char* contents, int chunk_size, int& readed);
 		void closeReadingFileForChunks();
 		/**
 			Load and cache zip file directory. Speed up locating files dramatically. Use before multiple read() calls.
+			Directory is loaded by open() already and cached in the data source, so it is read only once
+			even if the same data source is opened by content type detectors and a parser.
 		**/
 		bool loadDirectory();
 };
@@ -10,9 +10,12 @@
 /*********************************************************************************************************************************************/
 
 #include "base64.h"
+#include "cell_address.h"
 #include <boost/algorithm/string.hpp>
 #include <boost/json.hpp>
 #include "chaining.h"
+#include "collapse_whitespaces.h"
+#include "charset_converter.h"
 #include "content_type.h"
 #include "content_type_by_file_extension.h"
 #include "content_type_by_signature.h"
@@ -49,8 +52,12 @@
 #include "output.h"
 #include "plain_text_exporter.h"
 #include "post.h"
+#include "profiling.h"
+#include "resource_pool.h"
 #include "throw_if.h"
+#include "transformer_func.h"
 #include "txt_parser.h"
+#include "zip_reader.h"
 #include "input.h"
 #include "log.h"
 #include "lru_memory_cache.h"
@@ -1011,6 +1018,181 @@ TEST(DataSource, unseekable_stream_ptr_temp)
     ASSERT_EQ(data.string(), test_data_str);
 }
 
+TEST(DataSource, unseekable_stream_ptr_size_hint)
+{
+    std::string test_data_str = create_datasource_test_data_str();
+    for (size_t size_hint : { size_t{0}, test_data_str.size(), test_data_str.size() * 2 })
+    {
+        data_source data{unseekable_stream_ptr{std::make_shared<std::istringstream>(test_data_str), size_hint}};
+        ASSERT_EQ(data.string(length_limit{256}), test_data_str.substr(0, 256));
+        ASSERT_EQ(data.string(), test_data_str);
+    }
+}
+
+TEST(DataSource, unseekable_stream_ptr_stable_span)
+{
+    std::string test_data_str = create_datasource_test_data_str();
+    data_source data{unseekable_stream_ptr{std::make_shared<std::istringstream>(test_data_str)}};
+    std::span<const std::byte> whole_data = data.span();
+    ASSERT_EQ(data.span().data(), whole_data.data());
+    ASSERT_EQ(data.span(length_limit{256}).data(), whole_data.data());
+    ASSERT_EQ(data.span().size(), test_data_str.size());
+    ASSERT_EQ(data.span().data(), whole_data.data());
+}
+
+TEST(DataSource, path)
+{
+    std::string test_data_str = create_datasource_test_data_str();
+    std::filesystem::path test_path = std::filesystem::temp_directory_path() / "docwire_data_source_path_test.bin";
+    {
+        std::ofstream stream{test_path, std::ios::binary};
+        stream << test_data_str;
+    }
+    {
+        data_source data{test_path};
+        ASSERT_EQ(data.string(length_limit{256}), test_data_str.substr(0, 256));
+        ASSERT_EQ(data.string(), test_data_str);
+        ASSERT_EQ(data.span().data(), data.span(length_limit{256}).data());
+    }
+    std::filesystem::remove(test_path);
+}
+
+TEST(DataSource, path_concurrent_span)
+{
+    std::string test_data_str = create_datasource_test_data_str();
+    std::filesystem::path test_path = std::filesystem::temp_directory_path() / "docwire_data_source_concurrent_path_test.bin";
+    {
+        std::ofstream stream{test_path, std::ios::binary};
+        stream << test_data_str;
+    }
+    {
+        data_source data{test_path};
+        std::vector<std::future<std::span<const std::byte>>> spans;
+        for (int i = 0; i < 8; i++)
+            spans.push_back(std::async(std::launch::async, [&data]() { return data.span(); }));
+        std::span<const std::byte> whole_data = data.span();
+        for (auto& span : spans)
+            ASSERT_EQ(span.get().data(), whole_data.data());
+        ASSERT_EQ(whole_data.size(), test_data_str.size());
+    }
+    std::filesystem::remove(test_path);
+}
+
+TEST(DataSource, cached)
+{
+    data_source data{std::string{"test"}};
+    int created = 0;
+    std::function<std::shared_ptr<const std::string>()> create = [&created]()
+    {
+        created++;
+        return std::make_shared<const std::string>("value");
+    };
+    ASSERT_EQ(*data.cached<std::string>(create), "value");
+    ASSERT_EQ(data.cached<std::string>(create), data.cached<std::string>(create));
+    ASSERT_EQ(created, 1);
+    ASSERT_EQ(data.cached<int>([]() { return std::shared_ptr<const int>{}; }), nullptr);
+    ASSERT_EQ(*data.cached<int>([]() { return std::make_shared<const int>(1); }), 1);
+}
+
+TEST(ZipReader, directory_read_once)
+{
+    std::ifstream file{"1.docx", std::ios_base::binary};
+    std::vector<std::byte> data;
+    for (char c; file.get(c);)
+        data.push_back(static_cast<std::byte>(c));
+    data_source source{std::span<const std::byte>{data}};
+    ZipReader first_reader{source};
+    first_reader.open();
+    std::vector<std::string> names = first_reader.list();
+    ASSERT_FALSE(names.empty());
+    // Break signatures of central directory headers, so the directory cannot be read again.
+    std::array<std::byte, 4> signature {std::byte{'P'}, std::byte{'K'}, std::byte{1}, std::byte{2}};
+    for (auto i = std::search(data.begin(), data.end(), signature.begin(), signature.end()); i != data.end();
+            i = std::search(i, data.end(), signature.begin(), signature.end()))
+        *i = std::byte{'X'};
+    ZipReader second_reader{source};
+    second_reader.open();
+    EXPECT_EQ(second_reader.list(), names);
+    data_source other_source{std::span<const std::byte>{data}};
+    ZipReader other_reader{other_source};
+    other_reader.open();
+    EXPECT_TRUE(other_reader.list().empty());
+}
+
+namespace
+{
+
+std::vector<std::byte> read_file_bytes(const std::string& file_name)
+{
+    std::ifstream file{file_name, std::ios_base::binary};
+    std::vector<std::byte> data;
+    for (char c; file.get(c);)
+        data.push_back(static_cast<std::byte>(c));
+    return data;
+}
+
+/**
+    Breaks signature of the last central directory header, so zip directory index cannot be read
+    and only entries before the last one can be walked through.
+*/
+void break_last_zip_directory_entry(std::vector<std::byte>& data)
+{
+    std::array<std::byte, 4> signature {std::byte{'P'}, std::byte{'K'}, std::byte{1}, std::byte{2}};
+    auto last_header = std::find_end(data.begin(), data.end(), signature.begin(), signature.end());
+    ASSERT_NE(last_header, data.end());
+    *last_header = std::byte{'X'};
+}
+
+} // anonymous namespace
+
+TEST(ZipReader, list)
+{
+    std::vector<std::byte> data = read_file_bytes("8.pptx");
+    std::vector<std::string> slides {"ppt/slides/slide1.xml", "ppt/slides/slide2.xml", "ppt/slides/slide3.xml",
+        "ppt/slides/slide4.xml", "ppt/slides/slide5.xml"};
+    {
+        data_source source{std::span<const std::byte>{data}};
+        ZipReader reader{source};
+        reader.open();
+        EXPECT_EQ(reader.list("ppt/slides/slide"), slides);
+        EXPECT_EQ(reader.list().size(), 69u);
+    }
+    break_last_zip_directory_entry(data);
+    {
+        data_source source{std::span<const std::byte>{data}};
+        ZipReader reader{source};
+        reader.open();
+        EXPECT_FALSE(reader.loadDirectory());
+        EXPECT_EQ(reader.list("ppt/slides/slide"), slides);
+        EXPECT_EQ(reader.list().size(), 68u);
+    }
+}
+
+TEST(ODFOOXMLParser, slide_count_without_zip_directory_index)
+{
+    std::vector<std::byte> data = read_file_bytes("8.pptx");
+    break_last_zip_directory_entry(data);
+    std::ostringstream output;
+    data_source{std::span<const std::byte>{data}, file_extension{".pptx"}} |
+        content_type::by_file_extension::detector{} |
+        office_formats_parser{} |
+        MetaDataExporter() |
+        output;
+    EXPECT_THAT(output.str(), testing::HasSubstr("Page count: 5\n"));
+}
+
+TEST(DataSource, empty_path)
+{
+    std::filesystem::path test_path = std::filesystem::temp_directory_path() / "docwire_data_source_empty_path_test.bin";
+    std::ofstream{test_path, std::ios::binary}.close();
+    {
+        data_source data{test_path};
+        ASSERT_EQ(data.string(), "");
+        ASSERT_TRUE(data.span().empty());
+    }
+    std::filesystem::remove(test_path);
+}
+
 template <typename stream_ptr_type>
 void test_data_source_incremental()
 {
@@ -1130,6 +1312,125 @@ TEST(PlainTextExporter, custom_link_formatting)
     ASSERT_EQ(output_stream.str(), "(https://docwire.io)[DocWire SDK home page]\n");
 }
 
+TEST(HtmlExporter, attributes_with_special_characters)
+{
+    HtmlExporter exporter;
+    std::ostringstream output_stream{};
+    auto parsing_chain = exporter | output_stream;
+    std::vector<Tag> tags
+    {
+        tag::Document{},
+        tag::Paragraph{},
+        tag::Link{.url = "https://docwire.io/?a=1&b=\"2\"",
+            .styling = {.classes = {"first", "sec<ond"}, .id = "link'id", .style = "color: red"}},
+        tag::Text{.text = "link"},
+        tag::CloseLink{},
+        tag::Image{.src = "image.png?a=1&b=2", .alt = "<alt>", .styling = {.classes = {"image"}}},
+        tag::Image{.src = "no_alt.png", .styling = {.id = "\"id\"", .style = "width: 1px"}},
+        tag::CloseParagraph{},
+        tag::List{.type = "custom'\"", .styling = {.id = "list", .style = "margin: 0"}},
+        tag::ListItem{},
+        tag::Text{.text = "item"},
+        tag::CloseListItem{},
+        tag::CloseList{},
+        tag::List{.type = "disc", .styling = {.classes = {"a&b"}}},
+        tag::CloseList{},
+        tag::CloseDocument{}
+    };
+    for (auto tag: tags)
+    {
+        parsing_chain(tag);
+    }
+    // Attributes are written in alphabetical order of their names
+    ASSERT_EQ(output_stream.str(),
+        "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n<title>DocWire</title>\n</head>\n<body>\n"
+        "<p>"
+        "<a class=\"first sec&lt;ond\" href=\"https://docwire.io/?a=1&amp;b=&quot;2&quot;\" id=\"link&apos;id\" style=\"color: red\">"
+        "link</a>"
+        "<img alt=\"&lt;alt&gt;\" class=\"image\" src=\"image.png?a=1&amp;b=2\">"
+        "<img alt=\"\" id=\"&quot;id&quot;\" src=\"no_alt.png\" style=\"width: 1px\">"
+        "</p>"
+        "<ul id=\"list\" style=\"margin: 0; list-style-type: &quot;custom&apos;&quot;&quot;\"><li>item</li></ul>"
+        "<ul class=\"a&amp;b\" style=\"list-style-type: disc\"></ul>"
+        "</body>\n</html>\n");
+}
+
+namespace
+{
+
+std::string export_plain_text_crlf(const std::vector<Tag>& tags)
+{
+    PlainTextExporter exporter(
+        eol_sequence{"\r\n"},
+        link_formatter{
+            .format_opening = [](const tag::Link& link){ return std::string{"<"}; },
+            .format_closing = [](const tag::CloseLink& link){ return std::string{">"}; }
+        });
+    std::ostringstream output_stream{};
+    auto parsing_chain = exporter | output_stream;
+    parsing_chain(tag::Document{});
+    for (auto tag: tags)
+    {
+        parsing_chain(tag);
+    }
+    parsing_chain(tag::CloseDocument{});
+    return output_stream.str();
+}
+
+} // anonymous namespace
+
+TEST(PlainTextExporter, table_cell_eol_sequence_split_between_fragments)
+{
+    std::vector<Tag> tags
+    {
+        tag::Table{}, tag::TableRow{},
+        tag::TableCell{}, tag::Text{.text = "first\r"}, tag::Text{.text = "\nsecond"}, tag::CloseTableCell{},
+        tag::TableCell{}, tag::Text{.text = "x"}, tag::CloseTableCell{},
+        tag::CloseTableRow{}, tag::CloseTable{}
+    };
+    ASSERT_EQ(export_plain_text_crlf(tags),
+        "first   x     \r\n"
+        "second        \r\n"
+        "\r\n");
+}
+
+TEST(PlainTextExporter, table_cell_with_long_text)
+{
+    std::vector<Tag> tags { tag::Table{}, tag::TableRow{}, tag::TableCell{} };
+    for (int line = 0; line < 4; ++line)
+    {
+        for (int i = 0; i < 1000; ++i)
+            tags.push_back(tag::Text{.text = "ab"});
+        tags.push_back(tag::Text{.text = "\r"});
+        tags.push_back(tag::Text{.text = "\n"});
+    }
+    tags.insert(tags.end(), { tag::CloseTableCell{}, tag::TableCell{}, tag::Text{.text = "x"}, tag::CloseTableCell{},
+        tag::CloseTableRow{}, tag::CloseTable{} });
+    std::string cell_line;
+    for (int i = 0; i < 1000; ++i)
+        cell_line += "ab";
+    std::string expected_output = cell_line + "  x" + std::string(1999, ' ') + "\r\n";
+    for (int line = 1; line < 4; ++line)
+        expected_output += cell_line + "  " + std::string(2000, ' ') + "\r\n";
+    expected_output += "\r\n";
+    ASSERT_EQ(export_plain_text_crlf(tags), expected_output);
+}
+
+TEST(PlainTextExporter, table_cell_starting_with_other_tag_than_text)
+{
+    std::vector<Tag> tags
+    {
+        tag::Table{}, tag::TableRow{},
+        tag::TableCell{}, tag::Link{.url = "https://docwire.io"}, tag::Text{.text = "link"}, tag::CloseLink{},
+        tag::BreakLine{}, tag::Text{.text = "z"}, tag::CloseTableCell{},
+        tag::CloseTableRow{}, tag::CloseTable{}
+    };
+    ASSERT_EQ(export_plain_text_crlf(tags),
+        "<link>\r\n"
+        "z     \r\n"
+        "\r\n");
+}
+
 template<typename RefOrOwnedType, typename ValueType>
 void test_ref_or_owned(int expected_result)
 {
@@ -1459,6 +1760,331 @@ TEST(TXTParser, paragraphs)
     ));    
 }
 
+TEST(charset_converter, utf16_byte_order_not_kept_between_converters)
+{
+    std::string little_endian {"\xFF\xFE" "a\0b\0", 6};
+    std::string big_endian {"\xFE\xFF" "\0c\0d", 6};
+    EXPECT_EQ(charset_converter{"UTF-16"}.to_utf8(little_endian), "ab");
+    EXPECT_EQ(charset_converter{"UTF-16"}.to_utf8(big_endian), "cd");
+    EXPECT_EQ(charset_converter{"UTF-16"}.to_utf8(little_endian), "ab");
+}
+
+TEST(charset_converter, ascii_fast_path)
+{
+    EXPECT_EQ(charset_converter{"ISO-8859-2"}.to_utf8("ASCII text"), "ASCII text");
+    EXPECT_EQ(charset_converter{"ISO-8859-2"}.to_utf8("\xB1"), "\xC4\x85");
+    EXPECT_EQ(charset_converter{"utf-8"}.to_utf8("\xC4\x85"), "\xC4\x85");
+    // ASCII bytes are not ASCII characters in UTF-16 and escape sequences switch charset in ISO-2022
+    EXPECT_EQ(charset_converter{"UTF-16LE"}.to_utf8(std::string{"a\0", 2}), "a");
+    EXPECT_EQ(charset_converter{"ISO-2022-JP"}.to_utf8("\x1B$B$\"\x1B(B"), "\xE3\x81\x82");
+}
+
+namespace
+{
+
+std::string collapsed_whitespaces(std::string text)
+{
+    collapse_whitespaces(text);
+    return text;
+}
+
+} // anonymous namespace
+
+TEST(collapse_whitespaces, short_text)
+{
+    EXPECT_EQ(collapsed_whitespaces(""), "");
+    EXPECT_EQ(collapsed_whitespaces(" "), " ");
+    EXPECT_EQ(collapsed_whitespaces("a  b\t\nc"), "a b c");
+    EXPECT_EQ(collapsed_whitespaces("\v\f"), " ");
+    EXPECT_EQ(collapsed_whitespaces("a\vb\fc"), "a b c");
+}
+
+TEST(collapse_whitespaces, long_text)
+{
+    // Sizes and positions chosen around 16 and 32 byte blocks processed with SIMD
+    std::string normalized_block(32, 'a');
+    normalized_block[7] = ' ';
+    normalized_block[20] = ' ';
+    EXPECT_EQ(collapsed_whitespaces(normalized_block + normalized_block), normalized_block + normalized_block);
+    EXPECT_EQ(collapsed_whitespaces(std::string(64, ' ')), " ");
+    EXPECT_EQ(collapsed_whitespaces(std::string(64, '\f')), " ");
+    EXPECT_EQ(collapsed_whitespaces(std::string(15, 'a') + "\v\r\n" + std::string(30, 'b')),
+        std::string(15, 'a') + " " + std::string(30, 'b'));
+    EXPECT_EQ(collapsed_whitespaces(std::string(31, 'a') + " \t" + std::string(31, 'b')),
+        std::string(31, 'a') + " " + std::string(31, 'b'));
+    EXPECT_EQ(collapsed_whitespaces(std::string(31, 'a') + std::string(34, ' ') + "b"),
+        std::string(31, 'a') + " b");
+    EXPECT_EQ(collapsed_whitespaces(std::string(47, 'a') + "  " + std::string(40, 'b') + " "),
+        std::string(47, 'a') + " " + std::string(40, 'b') + " ");
+}
+
+TEST(PlainTextExporter, flush_threshold)
+{
+    std::string test_input {"Line ends with LF\nLine ends with CR\rLine ends with CRLF\r\nLine without EOL"};
+    std::ostringstream whole_output;
+    docwire::data_source{test_input, mime_type{"text/plain"}, confidence::highest} |
+        TXTParser{} | PlainTextExporter{} | whole_output;
+    using namespace chaining;
+    std::vector<Tag> parsed_tags;
+    docwire::data_source{test_input, mime_type{"text/plain"}, confidence::highest} |
+        TXTParser{} | parsed_tags;
+    PlainTextExporter exporter{eol_sequence{"\n"}, PlainTextExporter::default_link_formatter, flush_threshold{20}};
+    std::vector<Tag> chunks;
+    for (Tag& tag : parsed_tags)
+        tag | exporter | chunks;
+    ASSERT_GT(chunks.size(), 2);
+    std::string streamed_output;
+    for (const Tag& chunk : chunks)
+    {
+        ASSERT_TRUE(std::holds_alternative<data_source>(chunk));
+        streamed_output += std::get<data_source>(chunk).string();
+    }
+    ASSERT_EQ(streamed_output, whole_output.str());
+}
+
+TEST(HtmlExporter, flush_threshold)
+{
+    std::string test_input {"Line ends with LF\nLine ends with CR\rLine ends with CRLF\r\nLine without EOL"};
+    std::ostringstream whole_output;
+    docwire::data_source{test_input, mime_type{"text/plain"}, confidence::highest} |
+        TXTParser{} | HtmlExporter{} | whole_output;
+    using namespace chaining;
+    std::vector<Tag> parsed_tags;
+    docwire::data_source{test_input, mime_type{"text/plain"}, confidence::highest} |
+        TXTParser{} | parsed_tags;
+    HtmlExporter exporter{flush_threshold{20}};
+    std::vector<Tag> chunks;
+    for (Tag& tag : parsed_tags)
+        tag | exporter | chunks;
+    ASSERT_GT(chunks.size(), 2);
+    std::string streamed_output;
+    for (const Tag& chunk : chunks)
+    {
+        ASSERT_TRUE(std::holds_alternative<data_source>(chunk));
+        streamed_output += std::get<data_source>(chunk).string();
+    }
+    ASSERT_EQ(streamed_output, whole_output.str());
+}
+
+TEST(profiling, element_and_tag_counters)
+{
+    std::string test_input {"Line ends with LF\nLine ends with CR\rLine ends with CRLF\r\nLine without EOL"};
+    std::ostringstream output_stream;
+    profiling::reset();
+    profiling::enable();
+    docwire::data_source{test_input, mime_type{"text/plain"}, confidence::highest} |
+        TXTParser{} | PlainTextExporter{} | output_stream;
+    profiling::enable(false);
+    std::vector<profiling::entry> entries = profiling::report();
+    auto find_entry = [&](const std::string& element, const std::string& tag)
+    {
+        return std::find_if(entries.begin(), entries.end(), [&](const profiling::entry& e)
+        {
+            return e.element == element && e.tag == tag;
+        });
+    };
+    auto parser_entry = find_entry("TXTParser", "data_source");
+    ASSERT_NE(parser_entry, entries.end());
+    ASSERT_EQ(parser_entry->calls, 1);
+    ASSERT_GE(parser_entry->inclusive_time, parser_entry->exclusive_time);
+    auto exporter_entry = find_entry("PlainTextExporter", "Text");
+    ASSERT_NE(exporter_entry, entries.end());
+    ASSERT_EQ(exporter_entry->calls, 4);
+    ASSERT_EQ(exporter_entry->text_bytes, 69);
+    ASSERT_EQ(find_entry("ParsingChain", "data_source"), entries.end());
+    profiling::reset();
+    ASSERT_TRUE(profiling::report().empty());
+}
+
+namespace
+{
+
+template <typename ParserType>
+std::string parse_to_plain_text(data_source data, ParserType parser)
+{
+    std::ostringstream output{};
+    std::move(data) |
+        content_type::by_file_extension::detector{} |
+        std::move(parser) | office_formats_parser{} |
+        PlainTextExporter() |
+        output;
+    return output.str();
+}
+
+/**
+    Checks that parser with workers produces the same text as sequential one, for file read from path and from stream.
+*/
+template <typename ParserType, typename WorkersType>
+void test_parser_workers(const std::string& file_name, WorkersType workers)
+{
+    for (bool from_stream : { false, true })
+    {
+        SCOPED_TRACE("from_stream = " + std::to_string(from_stream));
+        auto create_input = [&]()
+        {
+            return from_stream ?
+                data_source{unseekable_stream_ptr{std::make_shared<std::ifstream>(file_name, std::ios_base::binary)}, file_extension{std::filesystem::path{file_name}}} :
+                data_source{std::filesystem::path{file_name}};
+        };
+        std::string sequential_output = parse_to_plain_text(create_input(), ParserType{});
+        ASSERT_FALSE(sequential_output.empty());
+        EXPECT_EQ(sequential_output, parse_to_plain_text(create_input(), ParserType{workers}));
+    }
+}
+
+} // anonymous namespace
+
+TEST(PDFParser, page_workers)
+{
+    test_parser_workers<PDFParser>("multi_pages_1.pdf", pdf_page_workers{4});
+}
+
+TEST(ODFOOXMLParser, worksheet_workers)
+{
+    test_parser_workers<ODFOOXMLParser>("9.xlsx", worksheet_workers{4});
+}
+
+TEST(ODFOOXMLParser, worksheet_workers_failure)
+{
+    std::ifstream file{"9.xlsx", std::ios_base::binary};
+    std::vector<std::byte> data;
+    for (char c; file.get(c);)
+        data.push_back(static_cast<std::byte>(c));
+    // Break local header signature of the second sheet, so only its worker fails.
+    std::string sheet_name {"xl/worksheets/sheet2.xml"};
+    auto name_pos = std::search(data.begin(), data.end(), sheet_name.begin(), sheet_name.end(),
+        [](std::byte b, char c) { return b == static_cast<std::byte>(c); });
+    ASSERT_NE(name_pos, data.end());
+    auto header_pos = name_pos - 30;
+    ASSERT_EQ(header_pos[0], std::byte{'P'});
+    ASSERT_EQ(header_pos[2], std::byte{3});
+    header_pos[0] = std::byte{'X'};
+    for (unsigned int workers : { 1u, 4u })
+    {
+        SCOPED_TRACE("workers = " + std::to_string(workers));
+        EXPECT_ANY_THROW(parse_to_plain_text(data_source{data, file_extension{".xlsx"}}, ODFOOXMLParser{worksheet_workers{workers}}));
+    }
+}
+
+TEST(ODFOOXMLParser, cells_without_address)
+{
+    using namespace testing;
+    using namespace chaining;
+    std::vector<Tag> tags;
+    data_source{std::filesystem::path{"missing_cell_addresses.xlsx"},
+        mime_type{"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"}, confidence::highest} |
+        ODFOOXMLParser{} | tags;
+    auto row = std::find_if(tags.begin(), tags.end(), [](const Tag& tag) { return std::holds_alternative<tag::TableRow>(tag); });
+    ASSERT_NE(row, tags.end());
+    auto close_row = std::find_if(row, tags.end(), [](const Tag& tag) { return std::holds_alternative<tag::CloseTableRow>(tag); });
+    ASSERT_NE(close_row, tags.end());
+    // Cells without address are counted as next columns, so "C1" does not need filling with empty cells.
+    std::vector<Tag> row_tags{row + 1, close_row};
+    ASSERT_THAT(row_tags, ElementsAre(
+        VariantWith<tag::TableCell>(_),
+        VariantWith<tag::Text>(Field(&tag::Text::text, StrEq("Cell A1"))),
+        VariantWith<tag::CloseTableCell>(_),
+        VariantWith<tag::TableCell>(_),
+        VariantWith<tag::Text>(Field(&tag::Text::text, StrEq("Cell B1"))),
+        VariantWith<tag::CloseTableCell>(_),
+        VariantWith<tag::TableCell>(_),
+        VariantWith<tag::Text>(Field(&tag::Text::text, StrEq("Cell C1"))),
+        VariantWith<tag::CloseTableCell>(_)
+    ));
+}
+
+TEST(decode_cell_address, valid)
+{
+    std::optional<cell_address> addr = decode_cell_address("A1");
+    ASSERT_TRUE(addr);
+    EXPECT_EQ(addr->column, 1);
+    EXPECT_EQ(addr->row, 1);
+    addr = decode_cell_address("$A$1");
+    ASSERT_TRUE(addr);
+    EXPECT_EQ(addr->column, 1);
+    EXPECT_EQ(addr->row, 1);
+    addr = decode_cell_address("AB12");
+    ASSERT_TRUE(addr);
+    EXPECT_EQ(addr->column, 28);
+    EXPECT_EQ(addr->row, 12);
+    addr = decode_cell_address("XFD1048576");
+    ASSERT_TRUE(addr);
+    EXPECT_EQ(addr->column, 16384);
+    EXPECT_EQ(addr->row, 1048576);
+    addr = decode_cell_address("xfd1");
+    ASSERT_TRUE(addr);
+    EXPECT_EQ(addr->column, 16384);
+    EXPECT_EQ(addr->row, 1);
+}
+
+TEST(decode_cell_address, invalid)
+{
+    EXPECT_FALSE(decode_cell_address(""));
+    EXPECT_FALSE(decode_cell_address("A"));
+    EXPECT_FALSE(decode_cell_address("$A$"));
+    EXPECT_FALSE(decode_cell_address("12"));
+    EXPECT_FALSE(decode_cell_address("A1B"));
+    EXPECT_FALSE(decode_cell_address("A 1"));
+    EXPECT_FALSE(decode_cell_address("AAAA1"));
+    EXPECT_FALSE(decode_cell_address("A1234567890"));
+    EXPECT_FALSE(decode_cell_address("ZZZZZZZZZZZZZZ99999999999999999999"));
+}
+
+TEST(PSTParser, message_workers)
+{
+    test_parser_workers<PSTParser>("1.pst", pst_message_workers{4});
+}
+
+TEST(PSTParser, message_worker_parsers)
+{
+    std::string sequential_output = parse_to_plain_text(data_source{std::filesystem::path{"1.pst"}}, PSTParser{});
+    ASSERT_FALSE(sequential_output.empty());
+    pst_worker_parsers worker_parsers {[]() -> ref_or_owned<ChainElement>
+    {
+        return content_type::by_file_extension::detector{} | office_formats_parser{};
+    }};
+    EXPECT_EQ(sequential_output,
+        parse_to_plain_text(data_source{std::filesystem::path{"1.pst"}}, PSTParser{pst_message_workers{4}, worker_parsers}));
+}
+
+namespace
+{
+
+/**
+    Parses "1.pst" and, when the first mail is found, the same file again as if it was attached to the mail,
+    so the nested file is parsed by the same parser while workers of the outer file are still running.
+*/
+std::string parse_nested_pst(PSTParser parser)
+{
+    std::ostringstream output{};
+    bool nested = false;
+    std::optional<TransformerFunc> nest;
+    nest.emplace([&](Info& info)
+    {
+        if (nested || !std::holds_alternative<tag::Mail>(info.tag))
+            return;
+        nested = true;
+        Tag nested_pst {data_source{std::filesystem::path{"1.pst"}}};
+        nest->chain()->get().top_chain().process_in_place(nested_pst, [](Tag&) { return ChainElement::continuation::proceed; });
+    });
+    data_source{std::filesystem::path{"1.pst"}} |
+        content_type::by_file_extension::detector{} |
+        std::move(parser) | office_formats_parser{} |
+        *nest |
+        PlainTextExporter() |
+        output;
+    return output.str();
+}
+
+} // anonymous namespace
+
+TEST(PSTParser, nested_message_workers)
+{
+    std::string sequential_output = parse_nested_pst(PSTParser{});
+    ASSERT_GT(sequential_output.size(), parse_to_plain_text(data_source{std::filesystem::path{"1.pst"}}, PSTParser{}).size());
+    EXPECT_EQ(sequential_output, parse_nested_pst(PSTParser{pst_message_workers{4}}));
+}
+
 TEST(OCRParser, leptonica_stderr_capturer)
 {
     try
@@ -1477,6 +2103,91 @@ TEST(OCRParser, leptonica_stderr_capturer)
     }
 }
 
+TEST(OCRParser, more_parses_than_engines)
+{
+    auto ocr_to_plain_text = [](ocr_engine_pool_size pool_size)
+    {
+        std::ostringstream output_stream{};
+        std::filesystem::path{"1.png"} |
+            content_type::by_file_extension::detector{} |
+            OCRParser{{}, {}, {}, pool_size} |
+            PlainTextExporter{} |
+            output_stream;
+        return output_stream.str();
+    };
+    std::string expected_output = ocr_to_plain_text(ocr_engine_pool_size{1});
+    ASSERT_FALSE(expected_output.empty());
+    std::vector<std::future<std::string>> outputs;
+    for (int i = 0; i < 4; i++)
+        outputs.push_back(std::async(std::launch::async, ocr_to_plain_text, ocr_engine_pool_size{1}));
+    for (auto& output : outputs)
+        EXPECT_EQ(output.get(), expected_output);
+}
+
+TEST(resource_pool, resources_are_reused)
+{
+    resource_pool<std::string, std::unique_ptr<int>> pool;
+    int created = 0;
+    auto producer = [&created](const std::string& key) { return std::make_unique<int>(++created); };
+    auto lease = pool.checkout("a", 2, producer);
+    int* resource = lease->get();
+    lease.give_back();
+    auto lease_again = pool.checkout("a", 2, producer);
+    ASSERT_EQ(lease_again->get(), resource);
+    ASSERT_EQ(created, 1);
+    auto other_key_lease = pool.checkout("b", 2, producer);
+    ASSERT_NE(other_key_lease->get(), resource);
+    ASSERT_EQ(created, 2);
+    lease_again.give_back();
+    other_key_lease.give_back();
+}
+
+TEST(resource_pool, checkout_waits_for_resource_given_back)
+{
+    resource_pool<std::string, std::unique_ptr<int>> pool;
+    std::atomic<int> created = 0;
+    auto producer = [&created](const std::string& key) { return std::make_unique<int>(++created); };
+    auto first = pool.checkout("a", 2, producer);
+    auto second = pool.checkout("a", 2, producer);
+    int* first_resource = first->get();
+    std::future<int*> third = std::async(std::launch::async, [&]()
+    {
+        auto lease = pool.checkout("a", 2, producer);
+        int* resource = lease->get();
+        lease.give_back();
+        return resource;
+    });
+    ASSERT_EQ(third.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+    first.give_back();
+    ASSERT_EQ(third.get(), first_resource);
+    ASSERT_EQ(created, 2);
+    second.give_back();
+}
+
+TEST(resource_pool, discarded_resource_is_replaced)
+{
+    resource_pool<std::string, std::unique_ptr<int>> pool;
+    std::atomic<int> created = 0;
+    auto producer = [&created](const std::string& key) { return std::make_unique<int>(++created); };
+    std::optional<resource_pool<std::string, std::unique_ptr<int>>::lease> lease;
+    lease.emplace(pool.checkout("a", 1, producer));
+    std::future<int> next = std::async(std::launch::async, [&]()
+    {
+        auto lease = pool.checkout("a", 1, producer);
+        int value = **lease;
+        lease.give_back();
+        return value;
+    });
+    ASSERT_EQ(next.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+    lease.reset(); // destroyed without giving back, e.g. by an exception
+    ASSERT_EQ(next.get(), 2);
+    ASSERT_THROW(pool.checkout("b", 1, [](const std::string& key) -> std::unique_ptr<int> { throw std::runtime_error("failed"); }),
+        std::runtime_error);
+    auto after_failure = pool.checkout("b", 1, producer);
+    ASSERT_EQ(**after_failure, 3);
+    after_failure.give_back();
+}
+
 TEST(base64, encode)
 {
     const std::string input_str { "test" };
@@ -1576,6 +2287,102 @@ TEST(chaining, set_chain_get_chain_top_chain)
     ASSERT_EQ(&element1.chain()->get().top_chain(), &chain2);
 }
 
+namespace
+{
+
+class nested_text_parser : public Parser
+{
+public:
+    const std::vector<mime_type> supported_mime_types() override
+    {
+        return {mime_type{"application/x-docwire-test"}};
+    }
+
+protected:
+    void parse(const data_source& data) override
+    {
+        sendTag(data_source{data.string() + " nested", mime_type{"text/plain"}, confidence::highest});
+    }
+};
+
+} // anonymous namespace
+
+TEST(parser_dispatcher, dispatch_by_mime_type)
+{
+    using namespace testing;
+    using namespace chaining;
+    std::vector<Tag> tags;
+    data_source{std::string{"Text"}, mime_type{"text/plain"}, confidence::highest} |
+        parser_dispatcher{{nested_text_parser{}, TXTParser{parse_paragraphs{false}, parse_lines{false}}}} | tags;
+    ASSERT_THAT(tags, ElementsAre(
+        VariantWith<tag::Document>(_),
+        VariantWith<tag::Text>(Field(&tag::Text::text, StrEq("Text"))),
+        VariantWith<tag::CloseDocument>(_)
+    ));
+    tags.clear();
+    data_source{std::string{"Unknown"}, mime_type{"application/x-docwire-unknown"}, confidence::highest} |
+        parser_dispatcher{{nested_text_parser{}, TXTParser{}}} | tags;
+    ASSERT_THAT(tags, ElementsAre(VariantWith<data_source>(_)));
+    ASSERT_EQ(std::get<data_source>(tags[0]).string(), "Unknown");
+}
+
+TEST(parser_dispatcher, set_chain)
+{
+    using namespace testing;
+    using namespace chaining;
+    nested_text_parser nested_parser;
+    ASSERT_FALSE(nested_parser.chain());
+    std::vector<Tag> tags;
+    data_source{std::string{"Data"}, mime_type{"application/x-docwire-test"}, confidence::highest} |
+        parser_dispatcher{{nested_parser, TXTParser{parse_paragraphs{false}, parse_lines{false}}}} | tags;
+    ASSERT_TRUE(nested_parser.chain());
+    ASSERT_THAT(tags, ElementsAre(
+        VariantWith<tag::Document>(_),
+        VariantWith<tag::Text>(Field(&tag::Text::text, StrEq("Data nested"))),
+        VariantWith<tag::CloseDocument>(_)
+    ));
+}
+
+TEST(chaining, info_assignment)
+{
+    Info info{tag::Text{.text = "first"}};
+    Info other{tag::Text{.text = "second"}};
+    other.skip = true;
+    info = other;
+    ASSERT_EQ(std::get<tag::Text>(info.tag).text, "second");
+    ASSERT_TRUE(info.skip);
+    ASSERT_EQ(std::get<tag::Text>(other.tag).text, "second");
+    info = Info{tag::Paragraph{}};
+    ASSERT_TRUE(std::holds_alternative<tag::Paragraph>(info.tag));
+    ASSERT_FALSE(info.skip);
+    Tag borrowed_tag {tag::Text{.text = "borrowed"}};
+    Info borrowing{std::ref(borrowed_tag)};
+    borrowing = Info{tag::Text{.text = "assigned"}};
+    ASSERT_EQ(std::get<tag::Text>(borrowed_tag).text, "assigned");
+    info = Info{std::ref(borrowed_tag)};
+    ASSERT_EQ(std::get<tag::Text>(info.tag).text, "assigned");
+    ASSERT_EQ(std::get<tag::Text>(borrowed_tag).text, "assigned");
+}
+
+TEST(chaining, tags_are_passed_through_parsing_chain_without_copying)
+{
+    const std::string* text_seen_by_first = nullptr;
+    const std::string* text_seen_by_second = nullptr;
+    ParsingChain chain = TransformerFunc{[&](Info& info)
+        {
+            if (std::holds_alternative<tag::Text>(info.tag))
+                text_seen_by_first = &std::get<tag::Text>(info.tag).text;
+        }} |
+        TransformerFunc{[&](Info& info)
+        {
+            if (std::holds_alternative<tag::Text>(info.tag))
+                text_seen_by_second = &std::get<tag::Text>(info.tag).text;
+        }};
+    chain(tag::Text{.text = "text"});
+    ASSERT_NE(text_seen_by_first, nullptr);
+    ASSERT_EQ(text_seen_by_first, text_seen_by_second);
+}
+
 TEST(chaining, val_temp_to_func_ref_one_arg_no_result)
 {
     using namespace chaining;
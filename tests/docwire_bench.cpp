@@ -0,0 +1,276 @@
+/*********************************************************************************************************************************************/
+/*  DocWire SDK: Award-winning modern data processing in C++20. SourceForge Community Choice & Microsoft support. AI-driven processing.      */
+/*  Supports nearly 100 data formats, including email boxes and OCR. Boost efficiency in text extraction, web data extraction, data mining,  */
+/*  document analysis. Offline processing possible for security and confidentiality                                                          */
+/*                                                                                                                                           */
+/*  Copyright (c) SILVERCODERS Ltd, http://silvercoders.com                                                                                  */
+/*  Project homepage: https://github.com/docwire/docwire                                                                                     */
+/*                                                                                                                                           */
+/*  SPDX-License-Identifier: GPL-2.0-only OR LicenseRef-DocWire-Commercial                                                                   */
+/*********************************************************************************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <boost/json.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "docwire.h"
+#include "throw_if.h"
+#ifdef _WIN32
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
+// Benchmark of the real parsing chain over the speed.*.gz files bundled with tests.
+// Every file is decompressed once and then parsed the requested number of times.
+// Results are printed (or written to a file) as JSON to make comparing runs in CI easy.
+
+namespace
+{
+
+std::atomic<size_t> allocations_count { 0 };
+std::atomic<size_t> allocated_bytes { 0 };
+
+void* counted_allocate(std::size_t size) noexcept
+{
+	allocations_count.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+} // anonymous namespace
+
+void* operator new(std::size_t size)
+{
+	if (void* ptr = counted_allocate(size))
+		return ptr;
+	throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return counted_allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	std::free(ptr);
+}
+
+namespace
+{
+
+using namespace docwire;
+
+std::vector<std::byte> read_gzip_file(const std::filesystem::path& path)
+{
+	gzFile file = gzopen(path.string().c_str(), "rb");
+	throw_if (file == nullptr, "gzopen() failed", path);
+	std::vector<std::byte> data;
+	std::byte chunk[64 * 1024];
+	int read_bytes;
+	while ((read_bytes = gzread(file, chunk, sizeof(chunk))) > 0)
+		data.insert(data.end(), chunk, chunk + read_bytes);
+	int error_code;
+	std::string error_message = read_bytes < 0 ? gzerror(file, &error_code) : "";
+	gzclose(file);
+	throw_if (read_bytes < 0, "gzread() failed", path, error_message);
+	return data;
+}
+
+size_t peak_rss_bytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	#ifdef __APPLE__
+		return usage.ru_maxrss;
+	#else
+		return usage.ru_maxrss * 1024;
+	#endif
+#endif
+}
+
+double percentile(std::vector<double> values, double p)
+{
+	if (values.empty())
+		return 0;
+	std::sort(values.begin(), values.end());
+	size_t rank = static_cast<size_t>(p / 100.0 * values.size() + 0.5);
+	return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+}
+
+boost::json::object benchmark_file(const std::filesystem::path& path, unsigned int iterations)
+{
+	std::string format = path.stem().extension().string().substr(1);
+	std::vector<std::byte> data = read_gzip_file(path);
+	std::span<const std::byte> data_span { data };
+	file_extension extension { "." + format };
+
+	ParsingChain chain = content_type::detector{} | office_formats_parser{} | PlainTextExporter{};
+	std::ostringstream out_stream;
+	auto run = [&]()
+	{
+		out_stream.str({});
+		data_source{data_span, extension} | chain | out_stream;
+	};
+
+	run(); // warm-up: loads signatures database, fonts etc.
+	size_t output_size = out_stream.str().size();
+
+	std::vector<double> latencies_ms;
+	latencies_ms.reserve(iterations);
+	size_t allocations_before = allocations_count.load();
+	size_t allocated_bytes_before = allocated_bytes.load();
+	for (unsigned int i = 0; i < iterations; i++)
+	{
+		auto start_time = std::chrono::steady_clock::now();
+		run();
+		auto end_time = std::chrono::steady_clock::now();
+		latencies_ms.push_back(std::chrono::duration<double, std::milli>(end_time - start_time).count());
+	}
+	size_t allocations = allocations_count.load() - allocations_before;
+	size_t allocations_bytes = allocated_bytes.load() - allocated_bytes_before;
+
+	double total_ms = 0;
+	for (double latency_ms : latencies_ms)
+		total_ms += latency_ms;
+	double megabytes = static_cast<double>(data.size()) * iterations / (1024.0 * 1024.0);
+
+	return boost::json::object
+	{
+		{ "format", format },
+		{ "file", path.filename().string() },
+		{ "input_bytes", data.size() },
+		{ "output_bytes", output_size },
+		{ "iterations", iterations },
+		{ "mb_per_s", total_ms > 0 ? megabytes / (total_ms / 1000.0) : 0.0 },
+		{ "latency_ms_p50", percentile(latencies_ms, 50) },
+		{ "latency_ms_p99", percentile(latencies_ms, 99) },
+		{ "allocations_per_iteration", allocations / iterations },
+		{ "allocated_bytes_per_iteration", allocations_bytes / iterations }
+	};
+}
+
+void print_usage(std::ostream& stream)
+{
+	stream << "Usage: docwire_bench [--iterations <n>] [--input-dir <dir>] [--output <json_file>] [format ...]" << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+	unsigned int iterations = 5;
+	std::filesystem::path input_dir = ".";
+	std::optional<std::filesystem::path> output_path;
+	std::vector<std::string> formats;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		if (arg == "--help")
+		{
+			print_usage(std::cout);
+			return 0;
+		}
+		else if ((arg == "--iterations" || arg == "--input-dir" || arg == "--output") && i + 1 < argc)
+		{
+			std::string value = argv[++i];
+			if (arg == "--iterations")
+				iterations = std::max(1, std::atoi(value.c_str()));
+			else if (arg == "--input-dir")
+				input_dir = value;
+			else
+				output_path = value;
+		}
+		else if (arg.starts_with("--"))
+		{
+			print_usage(std::cerr);
+			return 1;
+		}
+		else
+			formats.push_back(arg);
+	}
+
+	std::vector<std::filesystem::path> speed_files;
+	for (const auto& entry : std::filesystem::directory_iterator(input_dir))
+	{
+		std::string file_name = entry.path().filename().string();
+		if (!file_name.starts_with("speed.") || entry.path().extension() != ".gz")
+			continue;
+		std::string format = entry.path().stem().extension().string().substr(1);
+		if (formats.empty() || std::find(formats.begin(), formats.end(), format) != formats.end())
+			speed_files.push_back(entry.path());
+	}
+	std::sort(speed_files.begin(), speed_files.end());
+	if (speed_files.empty())
+	{
+		std::cerr << "[ERROR] No speed.*.gz files found in " << input_dir << std::endl;
+		return 1;
+	}
+
+	boost::json::array results;
+	bool failed = false;
+	for (const auto& speed_file : speed_files)
+	{
+		try
+		{
+			std::clog << "[INFO] Benchmarking " << speed_file.filename().string() << std::endl;
+			results.push_back(benchmark_file(speed_file, iterations));
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << "[ERROR] " << speed_file.filename().string() << ": " << errors::diagnostic_message(e) << std::endl;
+			results.push_back(boost::json::object{
+				{ "file", speed_file.filename().string() },
+				{ "error", errors::diagnostic_message(e) }
+			});
+			failed = true;
+		}
+	}
+
+	boost::json::object report
+	{
+		{ "iterations", iterations },
+		{ "peak_rss_bytes", peak_rss_bytes() }, // process-wide high-water mark of all benchmarked formats
+		{ "results", std::move(results) }
+	};
+	if (output_path)
+	{
+		std::ofstream output_stream(*output_path);
+		output_stream << boost::json::serialize(report) << std::endl;
+	}
+	else
+		std::cout << boost::json::serialize(report) << std::endl;
+
+	return failed ? 1 : 0;
+}